@@ -8,10 +8,26 @@
 
 // Foundation
 #include "src/types.h"
+#include "src/gesture.h"
+#include "src/stats.h"
+#include "src/intern.h"
 #include "src/state.h"
+#include "src/series.h"
+#include "src/text_layout.h"
 #include "src/widget.h"
 #include "src/layout.h"
+#include "src/node_table.h"
+#include "src/touch_grid.h"
+#include "src/id_index.h"
+#include "src/touch_sampler.h"
+#include "src/idle.h"
+#include "src/snapshot.h"
+#include "src/trace.h"
+#include "src/energy.h"
+#include "src/pixel_cache.h"
+#include "src/overlay.h"
 #include "src/screen.h"
+#include "src/screen_stack.h"
 
 // Widgets
 #include "src/widgets/text_widget.h"
@@ -24,13 +40,18 @@
 #include "src/widgets/keyboard_widget.h"
 #include "src/widgets/text_area_widget.h"
 #include "src/widgets/battery_widget.h"
+#include "src/widgets/table_widget.h"
+#include "src/widgets/chart_widget.h"
 
 // Layouts
 #include "src/layouts/column.h"
 #include "src/layouts/row.h"
 #include "src/layouts/stack.h"
+#include "src/layouts/switcher.h"
+#include "src/layouts/grid.h"
 #include "src/layouts/spacer.h"
 
 // Builder API
 #include "src/pool.h"
 #include "src/ui.h"
+#include "src/static_ui.h"
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "stats.h"
+
+namespace PaperUI {
+
+// Relative energy of an EPD push: a fixed cost per display() call plus a
+// per-pixel cost that scales with the waveform length of the mode. Units
+// are arbitrary; only ratios matter. Defaults follow the IT8951 waveform
+// times: quality (GC16) and text (GL16) ~450 ms, fastest (DU) ~260 ms,
+// fast (DU4) ~120 ms, so the fastest slot is not the cheapest one.
+struct EnergyModel {
+    uint32_t per_push = 20000;
+    uint8_t per_pixel[EPD_SLOTS] = {10, 10, 3, 6};   // quality, text, fast, fastest
+
+    uint32_t cost(const Rect& r, uint8_t slot) const {
+        return per_push + r.area() * per_pixel[slot < EPD_SLOTS ? slot : 0];
+    }
+
+    uint32_t fullRefreshCost() const {
+        return cost(Rect(0, 0, SCREEN_W, SCREEN_H), EPD_SLOT_QUALITY);
+    }
+};
+
+// Token bucket over push energy: refills at `per_hour`, holds at most
+// `burst`. Spending may go negative (urgent pushes, full refreshes); the
+// debt is paid back before deferred work runs again.
+class EnergyBudget {
+public:
+    // Budget expressed as full GC16 refreshes per hour; burst is how many
+    // can be spent back to back. 0 disables the governor.
+    void setRefreshesPerHour(float per_hour, float burst = 3, const EnergyModel& m = EnergyModel()) {
+        uint32_t full = m.fullRefreshCost();
+        _per_hour = (uint64_t)(per_hour * full);
+        _burst = (int64_t)(burst * full);
+        _tokens = _burst;
+        _last_ms = millis();
+    }
+
+    bool enabled() const { return _per_hour > 0; }
+
+    void refill(uint32_t now) {
+        uint32_t dt = now - _last_ms;
+        _last_ms = now;
+        uint64_t add = (uint64_t)dt * _per_hour + _carry;
+        _carry = add % 3600000ULL;
+        _tokens += (int64_t)(add / 3600000ULL);
+        if (_tokens > _burst) { _tokens = _burst; _carry = 0; }
+    }
+
+    // A cost larger than the whole bucket is allowed once the bucket is full
+    bool canSpend(uint32_t cost) const {
+        return _tokens >= min((int64_t)cost, _burst);
+    }
+
+    void spend(uint32_t cost) { _tokens -= cost; }
+
+    // Time until canSpend(cost) becomes true
+    uint32_t msUntil(uint32_t cost) const {
+        int64_t need = min((int64_t)cost, _burst) - _tokens;
+        if (need <= 0 || _per_hour == 0) return 0;
+        return (uint32_t)(((uint64_t)need * 3600000ULL + _per_hour - 1) / _per_hour);
+    }
+
+    int64_t tokens() const { return _tokens; }
+
+private:
+    uint64_t _per_hour = 0;
+    int64_t _burst = 0;
+    int64_t _tokens = 0;
+    uint64_t _carry = 0;
+    uint32_t _last_ms = 0;
+};
+
+} // namespace PaperUI
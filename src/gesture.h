@@ -0,0 +1,229 @@
+#pragma once
+
+#include "types.h"
+
+namespace PaperUI {
+
+constexpr unsigned long TOUCH_DEBOUNCE_MS = 80;
+
+// One touch controller reading
+struct TouchSample {
+    int16_t x, y;
+    uint32_t ms;
+    bool down;
+
+    TouchSample() : x(0), y(0), ms(0), down(false) {}
+    TouchSample(int16_t x, int16_t y, uint32_t ms, bool down)
+        : x(x), y(y), ms(ms), down(down) {}
+};
+
+enum class GestureType : uint8_t {
+    TAP,
+    LONG_PRESS,
+    SWIPE,        // fast release after a drag; see dir / vx / vy
+    DRAG_START,   // movement passed drag_threshold
+    DRAG,
+    DRAG_END
+};
+
+enum class SwipeDir : uint8_t { NONE, LEFT, RIGHT, UP, DOWN };
+
+struct GestureEvent {
+    GestureType type;
+    int16_t x, y;               // current point
+    int16_t start_x, start_y;   // where the finger went down
+    int16_t dx, dy;             // x - start_x, y - start_y
+    int16_t vx, vy;             // px/s, set on SWIPE and DRAG_END
+    SwipeDir dir;               // set on SWIPE
+    uint32_t duration_ms;       // since DOWN
+
+    GestureEvent()
+        : type(GestureType::TAP), x(0), y(0), start_x(0), start_y(0),
+          dx(0), dy(0), vx(0), vy(0), dir(SwipeDir::NONE), duration_ms(0) {}
+};
+
+using OnGestureCallback = void (*)(void* user_data, const GestureEvent& g);
+
+struct GestureConfig {
+    uint16_t debounce_ms = TOUCH_DEBOUNCE_MS;  // ignore a new DOWN this soon after UP
+    uint16_t move_step = 4;             // px between delivered MOVE events
+    uint16_t tap_slop = 12;             // max travel for a TAP
+    uint16_t drag_threshold = 12;       // travel before DRAG_START
+    uint16_t long_press_ms = 600;
+    uint16_t swipe_min_velocity = 400;  // px/s at release
+};
+
+// What one sample produced: at most one raw event and a few gestures.
+struct GestureResult {
+    bool has_raw = false;
+    TouchEvent raw;
+    uint8_t count = 0;
+    GestureEvent events[2];
+};
+
+// Turns timestamped samples into raw DOWN/MOVE/UP (with MOVE coalesced to
+// move_step) plus TAP / LONG_PRESS / DRAG_* / SWIPE gestures. Feed every
+// sample, including "not touching" ones so releases and long presses are
+// seen on time.
+class GestureRecognizer {
+public:
+    GestureConfig& config() { return _cfg; }
+    bool isDown() const { return _down; }
+
+    // `deliver_move` = false folds a MOVE into the next sample: the sample
+    // still counts for velocity, drag start and long press, but produces no
+    // raw MOVE / DRAG (used when draining a backlog of queued samples).
+    GestureResult feed(const TouchSample& s, bool deliver_move = true) {
+        GestureResult r;
+        if (s.down) {
+            if (!_down) {
+                if (_debounce_until && (int32_t)(s.ms - _debounce_until) < 0) return r;
+                _debounce_until = 0;
+                begin(s, r);
+            } else {
+                move(s, r, deliver_move);
+            }
+        } else if (_down) {
+            end(s.ms, r);
+        }
+        return r;
+    }
+
+    // Advance time without a new sample (finger held still): fires a due
+    // LONG_PRESS.
+    GestureResult poll(uint32_t ms) {
+        GestureResult r;
+        if (_down) checkLongPress(ms, r);
+        return r;
+    }
+
+private:
+    void begin(const TouchSample& s, GestureResult& r) {
+        _down = true;
+        _dragging = false;
+        _long_fired = false;
+        _start = s;
+        _last = s;
+        _sent_x = s.x;
+        _sent_y = s.y;
+        _hist_n = 0;
+        remember(s);
+        raw(r, s.x, s.y, TouchAction::DOWN);
+    }
+
+    void move(const TouchSample& s, GestureResult& r, bool deliver) {
+        _last = s;
+        remember(s);
+
+        int16_t dx = s.x - _start.x, dy = s.y - _start.y;
+        if (!_dragging && !_long_fired && dist2(dx, dy) > sq(_cfg.drag_threshold)) {
+            _dragging = true;
+            emit(r, GestureType::DRAG_START, s);
+        }
+
+        // Coalesce: only report movement of at least move_step px
+        if (deliver && dist2(s.x - _sent_x, s.y - _sent_y) >= sq(_cfg.move_step)) {
+            _sent_x = s.x;
+            _sent_y = s.y;
+            raw(r, s.x, s.y, TouchAction::MOVE);
+            if (_dragging) emit(r, GestureType::DRAG, s);
+        }
+
+        checkLongPress(s.ms, r);
+    }
+
+    void checkLongPress(uint32_t ms, GestureResult& r) {
+        if (!_dragging && !_long_fired && ms - _start.ms >= _cfg.long_press_ms) {
+            _long_fired = true;
+            emit(r, GestureType::LONG_PRESS, TouchSample(_last.x, _last.y, ms, true));
+        }
+    }
+
+    void end(uint32_t ms, GestureResult& r) {
+        _down = false;
+        _debounce_until = ms + _cfg.debounce_ms;
+        TouchSample s(_last.x, _last.y, ms, false);
+        raw(r, s.x, s.y, TouchAction::UP);
+
+        if (_dragging) {
+            GestureEvent& e = emit(r, GestureType::DRAG_END, s);
+            velocity(e.vx, e.vy);
+            int32_t speed2 = (int32_t)e.vx * e.vx + (int32_t)e.vy * e.vy;
+            if (speed2 >= sq(_cfg.swipe_min_velocity)) {
+                GestureEvent& sw = emit(r, GestureType::SWIPE, s);
+                sw.vx = e.vx;
+                sw.vy = e.vy;
+                if (abs(sw.dx) >= abs(sw.dy)) sw.dir = sw.dx < 0 ? SwipeDir::LEFT : SwipeDir::RIGHT;
+                else                          sw.dir = sw.dy < 0 ? SwipeDir::UP : SwipeDir::DOWN;
+            }
+        } else if (!_long_fired &&
+                   dist2(s.x - _start.x, s.y - _start.y) <= sq(_cfg.tap_slop)) {
+            emit(r, GestureType::TAP, s);
+        }
+    }
+
+    void raw(GestureResult& r, int16_t x, int16_t y, TouchAction a) {
+        r.has_raw = true;
+        r.raw.x = x;
+        r.raw.y = y;
+        r.raw.action = a;
+    }
+
+    GestureEvent& emit(GestureResult& r, GestureType t, const TouchSample& s) {
+        uint8_t i = r.count < 2 ? r.count++ : 1;
+        GestureEvent& e = r.events[i];
+        e = GestureEvent();
+        e.type = t;
+        e.x = s.x;
+        e.y = s.y;
+        e.start_x = _start.x;
+        e.start_y = _start.y;
+        e.dx = s.x - _start.x;
+        e.dy = s.y - _start.y;
+        e.duration_ms = s.ms - _start.ms;
+        return e;
+    }
+
+    // Velocity over the most recent samples (up to HIST, within 100 ms)
+    void velocity(int16_t& vx, int16_t& vy) const {
+        vx = vy = 0;
+        if (_hist_n < 2) return;
+        const TouchSample& a = _hist[(_hist_head + HIST - _hist_n) % HIST];
+        const TouchSample& b = _hist[(_hist_head + HIST - 1) % HIST];
+        uint32_t dt = b.ms - a.ms;
+        if (dt == 0 || dt > 100) return;
+        vx = (int16_t)constrain((int32_t)(b.x - a.x) * 1000 / (int32_t)dt, -32000L, 32000L);
+        vy = (int16_t)constrain((int32_t)(b.y - a.y) * 1000 / (int32_t)dt, -32000L, 32000L);
+    }
+
+    void remember(const TouchSample& s) {
+        // Keep only samples from the last 100 ms
+        _hist[_hist_head] = s;
+        _hist_head = (_hist_head + 1) % HIST;
+        if (_hist_n < HIST) _hist_n++;
+        while (_hist_n > 1 &&
+               s.ms - _hist[(_hist_head + HIST - _hist_n) % HIST].ms > 100) {
+            _hist_n--;
+        }
+    }
+
+    static int32_t sq(int32_t v) { return v * v; }
+    static int32_t dist2(int32_t dx, int32_t dy) { return dx * dx + dy * dy; }
+
+    static constexpr uint8_t HIST = 4;
+
+    GestureConfig _cfg;
+    bool _down = false;
+    bool _dragging = false;
+    bool _long_fired = false;
+    TouchSample _start;
+    TouchSample _last;
+    int16_t _sent_x = 0;
+    int16_t _sent_y = 0;
+    uint32_t _debounce_until = 0;
+    TouchSample _hist[HIST];
+    uint8_t _hist_head = 0;
+    uint8_t _hist_n = 0;
+};
+
+} // namespace PaperUI
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "node_table.h"
+
+namespace PaperUI {
+
+constexpr uint16_t idIndexSlots(uint16_t n, uint16_t p = 1) {
+    return p >= n ? p : idIndexSlots(n, (uint16_t)(p * 2));
+}
+
+#ifndef PAPERUI_ID_INDEX_SLOTS
+#define PAPERUI_ID_INDEX_SLOTS (PAPERUI_MAX_NODES * 2)
+#endif
+
+// Open-addressing hash of Widget::id -> node index, built from the
+// NodeTable so routing a message to a widget is one probe instead of a
+// tree walk. Linear probing over a power-of-two table at most half full
+// (4 bytes per slot). Id 0 means "no id" and is not indexed; for duplicate
+// ids the first in pre-order wins.
+class IdIndex {
+public:
+    static constexpr uint16_t SLOTS = idIndexSlots(PAPERUI_ID_INDEX_SLOTS);
+    static constexpr uint16_t MASK = SLOTS - 1;
+
+    void build(const NodeTable& nodes) {
+        for (uint16_t s = 0; s < SLOTS; s++) _key[s] = 0;
+        _count = 0;
+        _duplicates = 0;
+        _overflow = false;
+        for (uint16_t i = 0; i < nodes.size(); i++) {
+            uint16_t id = nodes.widget[i]->id;
+            if (id == 0) continue;
+            if (_count >= SLOTS / 2) { _overflow = true; break; }
+            uint16_t s = slot(id);
+            while (_key[s] != 0 && _key[s] != id) s = (s + 1) & MASK;
+            if (_key[s] == id) { _duplicates++; continue; }
+            _key[s] = id;
+            _node[s] = i;
+            _count++;
+        }
+    }
+
+    // Node index for `id`, or NO_NODE
+    uint16_t lookup(uint16_t id) const {
+        if (id == 0) return NO_NODE;
+        for (uint16_t s = slot(id);; s = (s + 1) & MASK) {
+            if (_key[s] == id) return _node[s];
+            if (_key[s] == 0) return NO_NODE;
+        }
+    }
+
+    uint16_t size() const { return _count; }
+    uint16_t duplicates() const { return _duplicates; }
+    bool overflowed() const { return _overflow; }
+
+private:
+    // Fibonacci hashing spreads sequential ids across the table
+    static uint16_t slot(uint16_t id) {
+        return (uint16_t)(((uint32_t)id * 2654435769UL) >> 16) & MASK;
+    }
+
+    uint16_t _key[SLOTS];
+    uint16_t _node[SLOTS];
+    uint16_t _count = 0;
+    uint16_t _duplicates = 0;
+    bool _overflow = false;
+};
+
+} // namespace PaperUI
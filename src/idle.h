@@ -0,0 +1,116 @@
+#pragma once
+
+#include "types.h"
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+
+namespace PaperUI {
+
+#ifndef PAPERUI_WAKE_SLOTS
+#define PAPERUI_WAKE_SLOTS 4
+#endif
+
+// Times (millis) at which deferred work wants update() to run again.
+// Anything that postpones work (the app, throttled bindings, the refresh
+// budget) registers a deadline with requestWakeAt(); Screen::idle() never
+// sleeps past the earliest one. Up to PAPERUI_WAKE_SLOTS distinct deadlines
+// are kept; when full, the latest one is replaced by an earlier request.
+struct WakeSchedule {
+    static constexpr uint8_t SLOTS = PAPERUI_WAKE_SLOTS;
+
+    static void requestWakeAt(uint32_t ms) {
+        Slots& s = slots();
+        uint8_t latest = 0;
+        for (uint8_t i = 0; i < s.count; i++) {
+            if (s.at[i] == ms) return;
+            if ((int32_t)(s.at[i] - s.at[latest]) > 0) latest = i;
+        }
+        if (s.count < SLOTS) s.at[s.count++] = ms;
+        else if ((int32_t)(ms - s.at[latest]) < 0) s.at[latest] = ms;
+    }
+
+    // Drop deadlines that have passed; returns true if any had.
+    static bool expire(uint32_t now) {
+        Slots& s = slots();
+        bool any = false;
+        for (uint8_t i = 0; i < s.count;) {
+            if ((int32_t)(now - s.at[i]) >= 0) {
+                s.at[i] = s.at[--s.count];
+                any = true;
+            } else {
+                i++;
+            }
+        }
+        return any;
+    }
+
+    static bool pending() { return slots().count > 0; }
+
+    // Earliest deadline; only meaningful if pending()
+    static uint32_t deadline() {
+        const Slots& s = slots();
+        uint32_t d = s.count ? s.at[0] : 0;
+        for (uint8_t i = 1; i < s.count; i++) {
+            if ((int32_t)(s.at[i] - d) < 0) d = s.at[i];
+        }
+        return d;
+    }
+
+private:
+    struct Slots {
+        uint32_t at[SLOTS];
+        uint8_t count = 0;
+    };
+
+    static Slots& slots() {
+        static Slots s;
+        return s;
+    }
+};
+
+inline void requestWakeAt(uint32_t ms) { WakeSchedule::requestWakeAt(ms); }
+inline void requestWakeIn(uint32_t ms) { WakeSchedule::requestWakeAt(millis() + ms); }
+
+constexpr uint32_t IDLE_FOREVER = 0xFFFFFFFFUL;
+
+// Wake sources for Screen::idle(). Pins default to the M5Paper wiring
+// (GT911 INT on 36, buttons on 37/38/39, all active low); -1 disables one.
+struct IdleConfig {
+    int8_t touch_int_pin = 36;
+    int8_t button_pins[3] = {37, 38, 39};
+    uint32_t max_sleep_ms = IDLE_FOREVER;   // cap, e.g. for a watchdog or clock
+    uint16_t min_sleep_ms = 5;              // below this, don't bother sleeping
+};
+
+enum class IdleResult : uint8_t {
+    BUSY,    // work was due, did not sleep
+    TIMER,   // woke at the computed deadline
+    INPUT,   // woke on touch or button
+};
+
+// Light sleep until `ms` elapse or a configured pin goes low.
+inline IdleResult lightSleep(const IdleConfig& cfg, uint32_t ms) {
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+    if (ms != IDLE_FOREVER) esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000ULL);
+
+    bool any_pin = false;
+    int8_t pins[4] = {cfg.touch_int_pin, cfg.button_pins[0],
+                      cfg.button_pins[1], cfg.button_pins[2]};
+    for (int8_t p : pins) {
+        if (p < 0) continue;
+        gpio_wakeup_enable((gpio_num_t)p, GPIO_INTR_LOW_LEVEL);
+        any_pin = true;
+    }
+    if (any_pin) esp_sleep_enable_gpio_wakeup();
+    else if (ms == IDLE_FOREVER) return IdleResult::BUSY;   // nothing could wake us
+
+    esp_light_sleep_start();
+
+    for (int8_t p : pins) {
+        if (p >= 0) gpio_wakeup_disable((gpio_num_t)p);
+    }
+    return esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER
+               ? IdleResult::TIMER : IdleResult::INPUT;
+}
+
+} // namespace PaperUI
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "types.h"
+#include <string.h>
+
+#ifndef PAPERUI_STRING_ARENA
+#define PAPERUI_STRING_ARENA 1024
+#endif
+
+namespace PaperUI {
+
+// Fixed-size, reference-counted string store. Equal strings share one
+// copy; a copy stays put until its last reference is released, so the
+// pointer can be handed to widgets without caring about the lifetime of
+// the caller's buffer.
+//
+// Blocks are carved first-fit from a static buffer and merged with free
+// neighbours on release. Nothing moves, so there is no compaction: a full
+// arena makes intern() return nullptr and the caller keeps its own pointer.
+class StringArena {
+public:
+    static constexpr uint16_t CAPACITY = PAPERUI_STRING_ARENA;
+
+    // Copy of `s` holding one reference, or nullptr if it does not fit
+    static const char* intern(const char* s, const TextKey& k) {
+        Arena& a = arena();
+        uint16_t need = blockSize(k.len);
+        uint16_t fit = NONE;
+        for (uint16_t off = 0; off < a.top; off += header(off)->size) {
+            Entry* e = header(off);
+            if (e->refs == 0) {
+                if (fit == NONE && e->size >= need) fit = off;
+            } else if (e->len == k.len && e->hash == k.hash &&
+                       memcmp(text(off), s, k.len) == 0) {
+                e->refs++;
+                return text(off);
+            }
+        }
+
+        if (fit != NONE) {
+            split(fit, need);
+        } else if (need <= CAPACITY - a.top) {
+            fit = a.top;
+            header(fit)->size = need;
+            a.top += need;
+        } else {
+            a.failures++;
+            return nullptr;
+        }
+
+        Entry* e = header(fit);
+        e->refs = 1;
+        e->len = k.len;
+        e->hash = k.hash;
+        memcpy(text(fit), s, k.len);
+        text(fit)[k.len] = '\0';
+        a.used += e->size;
+        if (a.used > a.peak) a.peak = a.used;
+        return text(fit);
+    }
+
+    static const char* intern(const char* s) { return intern(s, TextKey(s)); }
+
+    static bool owns(const char* p) {
+        const Arena& a = arena();
+        const uint8_t* b = reinterpret_cast<const uint8_t*>(p);
+        return b >= a.buf + sizeof(Entry) && b < a.buf + a.top;
+    }
+
+    static void retain(const char* p) {
+        if (owns(p)) entry(p)->refs++;
+    }
+
+    // No-op for pointers the arena does not own
+    static void release(const char* p) {
+        if (!owns(p)) return;
+        Entry* e = entry(p);
+        if (e->refs == 0 || --e->refs > 0) return;
+        arena().used -= e->size;
+        coalesce();
+    }
+
+    static uint16_t used() { return arena().used; }
+    static uint16_t peak() { return arena().peak; }
+    static uint16_t failures() { return arena().failures; }
+
+private:
+    static constexpr uint16_t NONE = 0xFFFF;
+    static constexpr uint16_t MIN_SPLIT = 8;   // smallest leftover worth keeping
+
+    struct Entry {
+        uint16_t size;   // whole block, header included
+        uint16_t refs;   // 0 = free
+        uint16_t len;
+        uint32_t hash;
+    };
+
+    struct Arena {
+        alignas(4) uint8_t buf[CAPACITY];
+        uint16_t top = 0;
+        uint16_t used = 0;
+        uint16_t peak = 0;
+        uint16_t failures = 0;
+    };
+
+    static Arena& arena() {
+        static Arena a;
+        return a;
+    }
+
+    static uint16_t blockSize(uint16_t len) {
+        return (uint16_t)((sizeof(Entry) + len + 1 + 3) & ~3u);
+    }
+
+    static Entry* header(uint16_t off) { return reinterpret_cast<Entry*>(arena().buf + off); }
+    static char* text(uint16_t off) { return reinterpret_cast<char*>(arena().buf + off + sizeof(Entry)); }
+
+    static Entry* entry(const char* p) {
+        return reinterpret_cast<Entry*>(const_cast<char*>(p) - sizeof(Entry));
+    }
+
+    static void split(uint16_t off, uint16_t need) {
+        Entry* e = header(off);
+        if (e->size < need + MIN_SPLIT + (uint16_t)sizeof(Entry)) return;
+        Entry* rest = header(off + need);
+        rest->size = e->size - need;
+        rest->refs = 0;
+        e->size = need;
+    }
+
+    // Merge runs of free blocks and give a free tail back to the bump pointer
+    static void coalesce() {
+        Arena& a = arena();
+        uint16_t last_free = NONE;
+        for (uint16_t off = 0; off < a.top;) {
+            Entry* e = header(off);
+            uint16_t next = off + e->size;
+            if (e->refs == 0 && last_free != NONE) {
+                header(last_free)->size += e->size;
+            } else {
+                last_free = e->refs == 0 ? off : NONE;
+            }
+            off = next;
+        }
+        if (last_free != NONE) a.top = last_free;
+    }
+};
+
+} // namespace PaperUI
@@ -4,22 +4,52 @@
 
 namespace PaperUI {
 
-constexpr uint8_t MAX_CHILDREN = 16;
-
 class Layout : public Widget {
 public:
     Layout() = default;
 
+    // Children form an intrusive singly linked list through
+    // Widget::nextSibling(), so a layout costs the same with 2 or 200 children.
+    // A child still in another layout's list is moved out of it first.
     Layout& add(Widget* child) {
-        if (_child_count < MAX_CHILDREN) {
-            _children[_child_count++] = child;
-            child->setParent(this);
-        }
+        if (child->parent()) child->parent()->remove(child);
+        child->_next_sibling = nullptr;
+        if (_last_child) _last_child->_next_sibling = child;
+        else _first_child = child;
+        _last_child = child;
+        _child_count++;
+        child->setParent(this);
+        tree_gen()++;
         return *this;
     }
 
-    uint8_t childCount() const { return _child_count; }
-    Widget* child(uint8_t i) const { return _children[i]; }
+    // Unlink `child`; false if it is not in this layout's list (a stale
+    // parent pointer, e.g. on a copy in a static tree, is left alone)
+    virtual bool remove(Widget* child) {
+        Widget* prev = nullptr;
+        for (Widget* c = _first_child; c; prev = c, c = c->nextSibling()) {
+            if (c != child) continue;
+            if (prev) prev->_next_sibling = c->_next_sibling;
+            else _first_child = c->_next_sibling;
+            if (_last_child == c) _last_child = prev;
+            c->_next_sibling = nullptr;
+            c->setParent(nullptr);
+            _child_count--;
+            tree_gen()++;
+            return true;
+        }
+        return false;
+    }
+
+    uint16_t childCount() const { return _child_count; }
+    Widget* firstChild() const { return _first_child; }
+
+    // Walks the list; prefer firstChild()/nextSibling() in loops.
+    Widget* child(uint16_t i) const {
+        Widget* c = _first_child;
+        while (c && i--) c = c->nextSibling();
+        return c;
+    }
 
     // --- Widget overrides ---
 
@@ -29,24 +59,44 @@ public:
         if (_bg != Colors::WHITE) {
             gfx.fillRect(_bounds.x, _bounds.y, _bounds.w, _bounds.h, _bg);
         }
-        for (uint8_t i = 0; i < _child_count; i++) {
-            if (_children[i]->isVisible()) {
-                _children[i]->draw(gfx);
+        for (Widget* c = _first_child; c; c = c->nextSibling()) {
+            if (c->isVisible()) {
+                c->draw(gfx);
             }
         }
     }
 
-    // Dispatch touch to children in reverse order (topmost first)
+    // Dispatch touch to children in reverse order (topmost first).
+    // The list only links forward, so find the last hit before `limit`,
+    // and retry below it if that child does not consume the event.
     bool onTouch(const TouchEvent& event) override {
-        for (int8_t i = _child_count - 1; i >= 0; i--) {
-            if (_children[i]->isVisible() &&
-                _children[i]->bounds().contains(event.x, event.y)) {
-                if (_children[i]->onTouch(event)) return true;
+        Widget* limit = nullptr;
+        while (true) {
+            Widget* hit = nullptr;
+            for (Widget* c = _first_child; c != limit; c = c->nextSibling()) {
+                if (c->isVisible() && c->bounds().contains(event.x, event.y)) {
+                    hit = c;
+                }
             }
+            if (!hit) return false;
+            if (hit->onTouch(event)) return true;
+            limit = hit;
         }
-        return false;
     }
 
+    // A layout draws only its background, which its children cover; one
+    // that needs its own area pushed (Switcher on a page change) returns it.
+    uint8_t dirtyRects(Rect*, uint8_t) override { return 0; }
+
+    // Paint this subtree inside `region` from a pixel cache instead of
+    // drawing the children. False: draw them as usual.
+    virtual bool paintCached(M5GFX&, const Rect&) { return false; }
+
+    // Called on a dirty layout before its rects are cleared and redrawn,
+    // while the framebuffer still holds what the panel shows. `overlaid`:
+    // an overlay covers part of the bounds.
+    virtual void beforePaint(M5GFX&, bool /*overlaid*/) {}
+
     // Called by children when they become dirty
     void onChildDirty(Widget* child) {
         _dirty = true;
@@ -59,6 +109,7 @@ public:
     // --- Configuration ---
 
     Color background() const { return _bg; }
+    uint32_t contentHash() const override { return Hasher().add(_bg).value(); }
     void setBackground(Color c) { _bg = c; markDirty(); }
     void setPadding(EdgeInsets p) { _padding = p; markDirty(); }
     void setSpacing(int16_t s) { _spacing = s; markDirty(); }
@@ -71,8 +122,9 @@ public:
     Layout& bg(Color c) { setBackground(c); return *this; }
 
 protected:
-    Widget* _children[MAX_CHILDREN] = {};
-    uint8_t _child_count = 0;
+    Widget* _first_child = nullptr;
+    Widget* _last_child = nullptr;
+    uint16_t _child_count = 0;
     int16_t _spacing = 4;
     EdgeInsets _padding = {};
     Color _bg = Colors::WHITE;
@@ -24,12 +24,14 @@ public:
         int16_t max_w = 0;
         int16_t content_w = c.max_w - _padding.left - _padding.right;
 
-        for (uint8_t i = 0; i < _child_count; i++) {
-            if (!_children[i]->isVisible()) continue;
+        bool first = true;
+        for (Widget* ch = _first_child; ch; ch = ch->nextSibling()) {
+            if (!ch->isVisible()) continue;
             Constraints cc(0, 0, content_w, (int16_t)(c.max_h - total_h));
-            Size cs = _children[i]->measure(cc);
-            _measured[i] = cs;
-            if (i > 0) total_h += _spacing;
+            Size cs = ch->measure(cc);
+            ch->setMeasuredSize(cs);
+            if (!first) total_h += _spacing;
+            first = false;
             total_h += cs.h;
             if (cs.w > max_w) max_w = cs.w;
         }
@@ -45,10 +47,10 @@ public:
 
         // Count visible children and their total height
         int16_t total_child_h = 0;
-        uint8_t visible = 0;
-        for (uint8_t i = 0; i < _child_count; i++) {
-            if (!_children[i]->isVisible()) continue;
-            total_child_h += _measured[i].h;
+        uint16_t visible = 0;
+        for (Widget* ch = _first_child; ch; ch = ch->nextSibling()) {
+            if (!ch->isVisible()) continue;
+            total_child_h += ch->measuredSize().h;
             visible++;
         }
         int16_t total_spacing = (visible > 1) ? _spacing * (visible - 1) : 0;
@@ -80,10 +82,10 @@ public:
             default: break; // START
         }
 
-        for (uint8_t i = 0; i < _child_count; i++) {
-            if (!_children[i]->isVisible()) continue;
+        for (Widget* ch = _first_child; ch; ch = ch->nextSibling()) {
+            if (!ch->isVisible()) continue;
 
-            int16_t child_w = _measured[i].w;
+            int16_t child_w = ch->measuredSize().w;
             int16_t child_x = _bounds.x + _padding.left;
 
             switch (_cross_align) {
@@ -93,18 +95,17 @@ public:
                 default: break; // START
             }
 
-            _children[i]->place(child_x, cursor_y, child_w, _measured[i].h);
+            ch->place(child_x, cursor_y, child_w, ch->measuredSize().h);
 
-            if (_children[i]->isLayout()) {
-                static_cast<Layout*>(_children[i])->layout();
+            if (ch->isLayout()) {
+                static_cast<Layout*>(ch)->layout();
             }
 
-            cursor_y += _measured[i].h + gap;
+            cursor_y += ch->measuredSize().h + gap;
         }
     }
 
 private:
-    Size _measured[MAX_CHILDREN];
     Align _cross_align = Align::START;
     Arrangement _arrangement = Arrangement::START;
 };
@@ -0,0 +1,304 @@
+#pragma once
+
+#include "../layout.h"
+
+#ifndef PAPERUI_GRID_TRACKS
+#define PAPERUI_GRID_TRACKS 20
+#endif
+#ifndef PAPERUI_GRID_CELLS
+#define PAPERUI_GRID_CELLS 200
+#endif
+
+namespace PaperUI {
+
+// Size of one grid column or row
+struct GridTrack {
+    int16_t px = 0;   // fixed size; 0 with fr == 0 means fit the content
+    uint8_t fr = 0;   // share of the space left over by the other tracks
+
+    static GridTrack fixed(int16_t px) { GridTrack t; t.px = px; return t; }
+    static GridTrack fraction(uint8_t fr = 1) { GridTrack t; t.fr = fr; return t; }
+    static GridTrack fit() { return GridTrack(); }
+};
+
+// Children in rows and columns of tracks, spanning one or more cells.
+// Tracks are sized once per layout pass from the single-span children in
+// them (spanning children fit into the tracks they cover), and track edges
+// are kept so a point maps to its cell without visiting the children.
+//
+// add(w) flows into the next cell, row by row; add(w, col, row, ...) puts a
+// child at a given cell. At most PAPERUI_GRID_TRACKS columns and rows
+// (default 20), and PAPERUI_GRID_CELLS children (default 200); children
+// past those, or at a column past cols(), are not added. Every child is a
+// node, so a full 10x20 grid also needs PAPERUI_MAX_NODES above 200.
+class Grid : public Layout {
+public:
+    static constexpr uint8_t MAX_TRACKS = PAPERUI_GRID_TRACKS;
+    static constexpr uint16_t MAX_CELLS = PAPERUI_GRID_CELLS;
+    static constexpr uint8_t NO_TRACK = 0xFF;
+    static constexpr uint16_t NO_CELL = 0xFFFF;
+
+    Grid() {
+        for (uint8_t i = 0; i < MAX_TRACKS; i++) {
+            _cols[i] = GridTrack::fraction();
+            _rows[i] = GridTrack::fit();
+        }
+        for (uint16_t i = 0; i < (uint16_t)MAX_TRACKS * MAX_TRACKS; i++) _occupant[i] = NO_CELL;
+    }
+
+    // Fluent setters (covariant)
+    Grid& cols(uint8_t n, GridTrack t = GridTrack::fraction()) {
+        _ncols = min<uint8_t>(n, (uint8_t)MAX_TRACKS);
+        for (uint8_t i = 0; i < _ncols; i++) _cols[i] = t;
+        return *this;
+    }
+    Grid& rows(uint8_t n, GridTrack t = GridTrack::fit()) {
+        _nrows = min<uint8_t>(n, (uint8_t)MAX_TRACKS);
+        for (uint8_t i = 0; i < _nrows; i++) _rows[i] = t;
+        return *this;
+    }
+    Grid& col(uint8_t i, GridTrack t) { if (i < MAX_TRACKS) _cols[i] = t; return *this; }
+    Grid& row(uint8_t i, GridTrack t) { if (i < MAX_TRACKS) _rows[i] = t; return *this; }
+    Grid& align(Align h, Align v) { _align_h = h; _align_v = v; return *this; }
+    Grid& gap(int16_t col_gap, int16_t row_gap) {
+        setSpacing(col_gap);
+        _row_gap = row_gap;
+        return *this;
+    }
+    Grid& spacing(int16_t s) { return gap(s, s); }
+    Grid& padding(EdgeInsets p) { setPadding(p); return *this; }
+    Grid& padding(int16_t all) { setPadding(EdgeInsets::all(all)); return *this; }
+    Grid& padding(int16_t h, int16_t v) { setPadding(EdgeInsets::symmetric(h, v)); return *this; }
+    Grid& bg(Color c) { setBackground(c); return *this; }
+
+    // Next cell after the previous child, wrapping at the last column
+    Grid& add(Widget* child) {
+        uint8_t c = 0, r = 0;
+        if (_count > 0) {
+            const Cell& p = _cells[_count - 1];
+            c = p.col + p.col_span;
+            r = p.row;
+            if (c >= _ncols) { c = 0; r += p.row_span; }
+        }
+        return add(child, c, r);
+    }
+
+    Grid& add(Widget* child, uint8_t col, uint8_t row,
+              uint8_t col_span = 1, uint8_t row_span = 1) {
+        if (_count >= MAX_CELLS || col >= _ncols || row >= MAX_TRACKS) return *this;
+        Cell& cell = _cells[_count++];
+        cell.w = child;
+        cell.col = col;
+        cell.row = row;
+        cell.col_span = max<uint8_t>(col_span, 1);
+        cell.row_span = max<uint8_t>(row_span, 1);
+        if (row + cell.row_span > _nrows) _nrows = min<uint8_t>(row + cell.row_span, (uint8_t)MAX_TRACKS);
+        Layout::add(child);
+        return *this;
+    }
+
+    // Cells after it move down one index; the lookup follows them, and
+    // the cells it covered are empty until the next layout pass
+    bool remove(Widget* child) override {
+        if (!Layout::remove(child)) return false;
+        for (uint16_t k = 0; k < _count; k++) {
+            if (_cells[k].w != child) continue;
+            for (uint16_t j = k; j + 1 < _count; j++) _cells[j] = _cells[j + 1];
+            _count--;
+            for (uint16_t i = 0; i < (uint16_t)MAX_TRACKS * MAX_TRACKS; i++) {
+                if (_occupant[i] == NO_CELL || _occupant[i] < k) continue;
+                _occupant[i] = _occupant[i] == k ? NO_CELL : (uint16_t)(_occupant[i] - 1);
+            }
+            break;
+        }
+        return true;
+    }
+
+    uint8_t colCount() const { return _ncols; }
+    uint8_t rowCount() const { return _nrows; }
+
+    // Cell under (x, y), from the track edges of the last layout
+    bool cellAt(int16_t x, int16_t y, uint8_t& col, uint8_t& row) const {
+        col = trackAt(_col_x, _ncols, x);
+        row = trackAt(_row_y, _nrows, y);
+        return col != NO_TRACK && row != NO_TRACK;
+    }
+
+    // Screen rect of a cell (without the gaps around it)
+    Rect cellRect(uint8_t col, uint8_t row, uint8_t col_span = 1, uint8_t row_span = 1) const {
+        uint8_t c1 = min<uint8_t>(col + col_span, _ncols);
+        uint8_t r1 = min<uint8_t>(row + row_span, _nrows);
+        if (col >= c1 || row >= r1) return Rect();
+        return Rect(_col_x[col], _row_y[row],
+                    _col_x[c1] - _col_x[col] - _spacing,
+                    _row_y[r1] - _row_y[row] - _row_gap);
+    }
+
+    // Child covering a cell, or nullptr
+    Widget* childAt(uint8_t col, uint8_t row) const {
+        if (col >= _ncols || row >= _nrows) return nullptr;
+        uint16_t k = _occupant[row * MAX_TRACKS + col];
+        return k == NO_CELL ? nullptr : _cells[k].w;
+    }
+
+    // --- Widget overrides ---
+
+    Size measure(const Constraints& c) override {
+        int16_t avail_w = c.max_w - _padding.left - _padding.right;
+        int16_t avail_h = c.max_h - _padding.top - _padding.bottom;
+        for (uint8_t i = 0; i < MAX_TRACKS; i++) { _col_need[i] = 0; _row_need[i] = 0; }
+
+        for (uint16_t k = 0; k < _count; k++) {
+            const Cell& cell = _cells[k];
+            if (!cell.w->isVisible() || !placed(cell)) continue;
+            int16_t fw = spanFixed(_cols, cell.col, cell.col_span, _spacing);
+            int16_t fh = spanFixed(_rows, cell.row, cell.row_span, _row_gap);
+            Constraints cc(0, 0, fw > 0 ? fw : avail_w, fh > 0 ? fh : avail_h);
+            Size s = cell.w->measure(cc);
+            cell.w->setMeasuredSize(s);
+            if (cell.col_span == 1 && s.w > _col_need[cell.col]) _col_need[cell.col] = s.w;
+            if (cell.row_span == 1 && s.h > _row_need[cell.row]) _row_need[cell.row] = s.h;
+        }
+
+        int16_t w = natural(_cols, _col_need, _ncols, _spacing);
+        int16_t h = natural(_rows, _row_need, _nrows, _row_gap);
+        if (hasFraction(_cols, _ncols)) w = max(w, avail_w);
+        if (hasFraction(_rows, _nrows)) h = max(h, avail_h);
+        return Size(
+            (int16_t)constrain(w + _padding.left + _padding.right, c.min_w, c.max_w),
+            (int16_t)constrain(h + _padding.top + _padding.bottom, c.min_h, c.max_h)
+        );
+    }
+
+    void layout() override {
+        int16_t avail_w = _bounds.w - _padding.left - _padding.right;
+        int16_t avail_h = _bounds.h - _padding.top - _padding.bottom;
+        edges(_cols, _col_need, _ncols, _spacing, _bounds.x + _padding.left, avail_w, _col_x);
+        edges(_rows, _row_need, _nrows, _row_gap, _bounds.y + _padding.top, avail_h, _row_y);
+
+        for (uint16_t i = 0; i < (uint16_t)MAX_TRACKS * MAX_TRACKS; i++) _occupant[i] = NO_CELL;
+        for (uint16_t k = 0; k < _count; k++) {
+            const Cell& cell = _cells[k];
+            if (!cell.w->isVisible() || !placed(cell)) continue;
+            Rect r = cellRect(cell.col, cell.row, cell.col_span, cell.row_span);
+            Size s = cell.w->measuredSize();
+            int16_t x = r.x, y = r.y, w = min(s.w, r.w), h = min(s.h, r.h);
+            switch (_align_h) {
+                case Align::CENTER:  x += (r.w - w) / 2; break;
+                case Align::END:     x += r.w - w; break;
+                case Align::STRETCH: w = r.w; break;
+                default: break;
+            }
+            switch (_align_v) {
+                case Align::CENTER:  y += (r.h - h) / 2; break;
+                case Align::END:     y += r.h - h; break;
+                case Align::STRETCH: h = r.h; break;
+                default: break;
+            }
+            cell.w->place(x, y, w, h);
+            if (cell.w->isLayout()) static_cast<Layout*>(cell.w)->layout();
+            for (uint8_t rr = cell.row; rr < min<uint8_t>(cell.row + cell.row_span, _nrows); rr++) {
+                for (uint8_t cc = cell.col; cc < min<uint8_t>(cell.col + cell.col_span, _ncols); cc++) {
+                    if (_occupant[rr * MAX_TRACKS + cc] == NO_CELL) _occupant[rr * MAX_TRACKS + cc] = k;
+                }
+            }
+        }
+    }
+
+private:
+    struct Cell {
+        Widget* w = nullptr;
+        uint8_t col = 0, row = 0;
+        uint8_t col_span = 1, row_span = 1;
+    };
+
+    bool placed(const Cell& cell) const { return cell.col < _ncols && cell.row < _nrows; }
+
+    // Fixed size of a span when every track in it is fixed, else 0
+    static int16_t spanFixed(const GridTrack* t, uint8_t first, uint8_t span, int16_t gap) {
+        int16_t sum = 0;
+        for (uint8_t i = first; i < first + span && i < MAX_TRACKS; i++) {
+            if (t[i].fr || t[i].px == 0) return 0;
+            sum += t[i].px;
+        }
+        return sum + gap * (span - 1);
+    }
+
+    static bool hasFraction(const GridTrack* t, uint8_t n) {
+        for (uint8_t i = 0; i < n; i++) if (t[i].fr) return true;
+        return false;
+    }
+
+    static int16_t trackSize(const GridTrack& t, int16_t need) {
+        return t.px > 0 && t.fr == 0 ? t.px : need;
+    }
+
+    static int16_t natural(const GridTrack* t, const int16_t* need, uint8_t n, int16_t gap) {
+        int16_t sum = n > 1 ? gap * (n - 1) : 0;
+        for (uint8_t i = 0; i < n; i++) sum += trackSize(t[i], need[i]);
+        return sum;
+    }
+
+    // Start of each track (plus one past the last, gap included) in `out`.
+    // Fraction tracks share what the others leave, at least their content.
+    static void edges(const GridTrack* t, const int16_t* need, uint8_t n, int16_t gap,
+                      int16_t origin, int16_t avail, int16_t* out) {
+        int16_t fixed = n > 1 ? gap * (n - 1) : 0;
+        uint16_t total_fr = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            if (t[i].fr) total_fr += t[i].fr;
+            else fixed += trackSize(t[i], need[i]);
+        }
+        int16_t left = max<int16_t>(0, avail - fixed);
+        int16_t pos = origin;
+        uint16_t fr_seen = 0;
+        int16_t fr_given = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            out[i] = pos;
+            int16_t size;
+            if (t[i].fr) {
+                // Cumulative rounding so the shares add up to `left` exactly
+                fr_seen += t[i].fr;
+                int16_t upto = (int16_t)((int32_t)left * fr_seen / total_fr);
+                size = max<int16_t>(upto - fr_given, need[i]);
+                fr_given = upto;
+            } else {
+                size = trackSize(t[i], need[i]);
+            }
+            pos += size + gap;
+        }
+        out[n] = pos;
+    }
+
+    // Track containing `v`: a division by the first track's pitch, which is
+    // exact for uniform tracks; otherwise a scan of at most MAX_TRACKS
+    // edges. Gaps belong to no track.
+    uint8_t trackAt(const int16_t* e, uint8_t n, int16_t v) const {
+        if (n == 0 || v < e[0] || v >= e[n]) return NO_TRACK;
+        int16_t pitch = e[1] - e[0];
+        uint8_t i = pitch > 0 ? (uint8_t)min<int16_t>((v - e[0]) / pitch, n - 1) : 0;
+        if (v < e[i] || v >= e[i + 1]) {
+            i = 0;
+            while (i + 1 < n && v >= e[i + 1]) i++;
+        }
+        int16_t gap = e == _col_x ? _spacing : _row_gap;
+        return v < e[i + 1] - gap ? i : NO_TRACK;
+    }
+
+    GridTrack _cols[MAX_TRACKS];
+    GridTrack _rows[MAX_TRACKS];
+    int16_t _col_need[MAX_TRACKS] = {};
+    int16_t _row_need[MAX_TRACKS] = {};
+    int16_t _col_x[MAX_TRACKS + 1] = {};
+    int16_t _row_y[MAX_TRACKS + 1] = {};
+    Cell _cells[MAX_CELLS];
+    uint16_t _occupant[MAX_TRACKS * MAX_TRACKS];
+    uint16_t _count = 0;
+    uint8_t _ncols = 1;
+    uint8_t _nrows = 0;
+    int16_t _row_gap = 4;
+    Align _align_h = Align::STRETCH;
+    Align _align_v = Align::STRETCH;
+};
+
+} // namespace PaperUI
@@ -24,12 +24,14 @@ public:
         int16_t max_h = 0;
         int16_t content_h = c.max_h - _padding.top - _padding.bottom;
 
-        for (uint8_t i = 0; i < _child_count; i++) {
-            if (!_children[i]->isVisible()) continue;
+        bool first = true;
+        for (Widget* ch = _first_child; ch; ch = ch->nextSibling()) {
+            if (!ch->isVisible()) continue;
             Constraints cc(0, 0, (int16_t)(c.max_w - total_w), content_h);
-            Size cs = _children[i]->measure(cc);
-            _measured[i] = cs;
-            if (i > 0) total_w += _spacing;
+            Size cs = ch->measure(cc);
+            ch->setMeasuredSize(cs);
+            if (!first) total_w += _spacing;
+            first = false;
             total_w += cs.w;
             if (cs.h > max_h) max_h = cs.h;
         }
@@ -44,10 +46,10 @@ public:
         int16_t avail_h = _bounds.h - _padding.top - _padding.bottom;
 
         int16_t total_child_w = 0;
-        uint8_t visible = 0;
-        for (uint8_t i = 0; i < _child_count; i++) {
-            if (!_children[i]->isVisible()) continue;
-            total_child_w += _measured[i].w;
+        uint16_t visible = 0;
+        for (Widget* ch = _first_child; ch; ch = ch->nextSibling()) {
+            if (!ch->isVisible()) continue;
+            total_child_w += ch->measuredSize().w;
             visible++;
         }
         int16_t total_spacing = (visible > 1) ? _spacing * (visible - 1) : 0;
@@ -78,10 +80,10 @@ public:
             default: break;
         }
 
-        for (uint8_t i = 0; i < _child_count; i++) {
-            if (!_children[i]->isVisible()) continue;
+        for (Widget* ch = _first_child; ch; ch = ch->nextSibling()) {
+            if (!ch->isVisible()) continue;
 
-            int16_t child_h = _measured[i].h;
+            int16_t child_h = ch->measuredSize().h;
             int16_t child_y = _bounds.y + _padding.top;
 
             switch (_cross_align) {
@@ -91,18 +93,17 @@ public:
                 default: break;
             }
 
-            _children[i]->place(cursor_x, child_y, _measured[i].w, child_h);
+            ch->place(cursor_x, child_y, ch->measuredSize().w, child_h);
 
-            if (_children[i]->isLayout()) {
-                static_cast<Layout*>(_children[i])->layout();
+            if (ch->isLayout()) {
+                static_cast<Layout*>(ch)->layout();
             }
 
-            cursor_x += _measured[i].w + gap;
+            cursor_x += ch->measuredSize().w + gap;
         }
     }
 
 private:
-    Size _measured[MAX_CHILDREN];
     Align _cross_align = Align::START;
     Arrangement _arrangement = Arrangement::START;
 };
@@ -23,6 +23,8 @@ public:
 
     UpdateHint updateHint() const override { return UpdateHint::NONE; }
 
+    uint32_t contentHash() const override { return Hasher().value(); }
+
 private:
     int16_t _fixed_w = 0;
     int16_t _fixed_h = 0;
@@ -16,10 +16,10 @@ public:
 
     Size measure(const Constraints& c) override {
         int16_t max_w = 0, max_h = 0;
-        for (uint8_t i = 0; i < _child_count; i++) {
-            if (!_children[i]->isVisible()) continue;
-            Size s = _children[i]->measure(c);
-            _measured[i] = s;
+        for (Widget* ch = _first_child; ch; ch = ch->nextSibling()) {
+            if (!ch->isVisible()) continue;
+            Size s = ch->measure(c);
+            ch->setMeasuredSize(s);
             if (s.w > max_w) max_w = s.w;
             if (s.h > max_h) max_h = s.h;
         }
@@ -37,17 +37,14 @@ public:
         int16_t cw = _bounds.w - _padding.left - _padding.right;
         int16_t ch = _bounds.h - _padding.top - _padding.bottom;
 
-        for (uint8_t i = 0; i < _child_count; i++) {
-            if (!_children[i]->isVisible()) continue;
-            _children[i]->place(cx, cy, cw, ch);
-            if (_children[i]->isLayout()) {
-                static_cast<Layout*>(_children[i])->layout();
+        for (Widget* c = _first_child; c; c = c->nextSibling()) {
+            if (!c->isVisible()) continue;
+            c->place(cx, cy, cw, ch);
+            if (c->isLayout()) {
+                static_cast<Layout*>(c)->layout();
             }
         }
     }
-
-private:
-    Size _measured[MAX_CHILDREN];
 };
 
 } // namespace PaperUI
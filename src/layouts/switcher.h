@@ -0,0 +1,220 @@
+#pragma once
+
+#include "../layout.h"
+#include "../pixel_cache.h"
+
+#ifndef PAPERUI_SWITCHER_PAGES
+#define PAPERUI_SWITCHER_PAGES 6
+#endif
+
+namespace PaperUI {
+
+// Tabs: N pages in the same bounds, one shown at a time. Every page is
+// measured and placed once (all of them, whichever is shown), so select()
+// only flips visibility: no measure, no layout, no full refresh. The
+// switcher then pushes its own bounds as one rect in switchMode().
+//
+// With cachePages(true) the page being left is read back into a 4bpp
+// PixelCache from the screen's framebuffer just before the switch is
+// drawn (not while an overlay covers part of the switcher); coming back
+// to it copies those pixels instead of drawing its widgets, unless
+// something on the page changed meanwhile (the first
+// PAPERUI_SWITCHER_PAGES pages; default 6).
+// Hidden pages keep their bindings synced but draw nothing.
+class Switcher : public Layout {
+public:
+    static constexpr uint8_t MAX_PAGES = PAPERUI_SWITCHER_PAGES;   // with a pixel cache
+    static constexpr uint8_t NO_PAGE = 0xFF;
+
+    // Fluent setters (covariant)
+    Switcher& add(Widget* page) {
+        page->setVisible(_child_count == _active);
+        Layout::add(page);
+        _measured = false;
+        return *this;
+    }
+    // Pages after it move down one index; the active page stays shown
+    // (the next one if it was the active page)
+    bool remove(Widget* page) override {
+        uint8_t i = 0;
+        for (Widget* c = _first_child; c && c != page; c = c->nextSibling()) i++;
+        if (!Layout::remove(page)) return false;
+        for (uint8_t k = i; k < MAX_PAGES; k++) {
+            _pages[k].release();
+        }
+        if (_leaving >= i) _leaving = NO_PAGE;
+        if (i < _active) _active--;
+        if (_active >= _child_count) _active = _child_count ? _child_count - 1 : 0;
+        if (Widget* a = child(_active)) a->setVisible(true);
+        _measured = false;
+        return true;
+    }
+
+    Switcher& padding(EdgeInsets p) { setPadding(p); return *this; }
+    Switcher& padding(int16_t all) { setPadding(EdgeInsets::all(all)); return *this; }
+    Switcher& padding(int16_t h, int16_t v) { setPadding(EdgeInsets::symmetric(h, v)); return *this; }
+    Switcher& bg(Color c) { setBackground(c); return *this; }
+    Switcher& switchMode(UpdateHint h) { _mode = h; return *this; }
+    Switcher& onChange(OnChangeCallback cb, void* data = nullptr) {
+        _on_change = cb;
+        _user_data = data;
+        return *this;
+    }
+
+    Switcher& cachePages(bool on) {
+        _cache = on;
+        if (!on) {
+            for (uint8_t i = 0; i < MAX_PAGES; i++) _pages[i].release();
+        }
+        return *this;
+    }
+
+    uint8_t active() const { return _active; }
+    Widget* activePage() const { return child(_active); }
+
+    // Show page `i` instead of the current one
+    void select(uint8_t i) {
+        if (i == _active || i >= _child_count) return;
+        Widget* from = child(_active);
+        Widget* to = child(i);
+        if (_active < MAX_PAGES) _pages[_active].invalidate();
+        if (_cache && _measured && _active < MAX_PAGES && !_switching) {
+            // The panel still shows `from`: kept for coming back in
+            // beforePaint(), unless it has changes not shown yet
+            _page_hash[_active] = pageHash(from, true);
+            if (_page_hash[_active]) _leaving = _active;
+        }
+        from->setVisible(false);
+        to->setVisible(true);
+        clearTree(to);   // drawn whole within our rect
+        _active = i;
+        _switching = true;
+        markDirty();
+        if (_on_change) _on_change(_user_data, i);
+    }
+
+    // Measure the pages again on the next layout pass (their content
+    // changed size)
+    void remeasure() { _measured = false; }
+
+    // --- Widget overrides ---
+
+    // The largest page, measured once per constraints
+    Size measure(const Constraints& c) override {
+        if (!_measured || !sameConstraints(c, _measured_for)) {
+            Constraints inner(0, 0,
+                              max<int16_t>(0, c.max_w - _padding.left - _padding.right),
+                              max<int16_t>(0, c.max_h - _padding.top - _padding.bottom));
+            _content = Size();
+            for (Widget* ch = _first_child; ch; ch = ch->nextSibling()) {
+                Size s = ch->measure(inner);
+                ch->setMeasuredSize(s);
+                if (s.w > _content.w) _content.w = s.w;
+                if (s.h > _content.h) _content.h = s.h;
+            }
+            _measured = true;
+            _measured_for = c;
+        }
+        return Size(
+            (int16_t)constrain(_content.w + _padding.left + _padding.right, c.min_w, c.max_w),
+            (int16_t)constrain(_content.h + _padding.top + _padding.bottom, c.min_h, c.max_h)
+        );
+    }
+
+    // Hidden pages are placed too, so showing one needs no layout pass
+    void layout() override {
+        int16_t cx = _bounds.x + _padding.left;
+        int16_t cy = _bounds.y + _padding.top;
+        int16_t cw = _bounds.w - _padding.left - _padding.right;
+        int16_t ch = _bounds.h - _padding.top - _padding.bottom;
+        for (Widget* c = _first_child; c; c = c->nextSibling()) {
+            c->place(cx, cy, cw, ch);
+            if (c->isLayout()) static_cast<Layout*>(c)->layout();
+        }
+        for (uint8_t i = 0; i < MAX_PAGES; i++) _pages[i].invalidate();
+    }
+
+    uint8_t dirtyRects(Rect* out, uint8_t max) override {
+        if (!_switching || max == 0) return 0;
+        out[0] = _bounds;
+        return 1;
+    }
+
+    UpdateHint updateHint() const override {
+        return _switching ? _mode : UpdateHint::NONE;
+    }
+
+    bool paintCached(M5GFX& gfx, const Rect& region) override {
+        if (!_switching || !_cache || _active >= MAX_PAGES) return false;
+        const PixelCache& pc = _pages[_active];
+        if (!pc.valid() || !(pc.area() == _bounds) || !(region.unite(_bounds) == region)) {
+            return false;
+        }
+        uint32_t h = pageHash(child(_active));
+        if (h == 0 || h != _page_hash[_active]) return false;
+        return pc.restore(gfx);
+    }
+
+    // The framebuffer still shows the page being left; an overlay on it
+    // would end up in the copy
+    void beforePaint(M5GFX& gfx, bool overlaid) override {
+        if (_leaving >= MAX_PAGES) return;
+        if (!overlaid) _pages[_leaving].capture(gfx, _bounds);
+        _leaving = NO_PAGE;
+    }
+
+    void clearDirty() override {
+        _switching = false;
+        _leaving = NO_PAGE;
+        Layout::clearDirty();
+    }
+
+    uint32_t contentHash() const override {
+        return Hasher().add(_bg).add(_active).value();
+    }
+
+private:
+    static bool sameConstraints(const Constraints& a, const Constraints& b) {
+        return a.min_w == b.min_w && a.min_h == b.min_h &&
+               a.max_w == b.max_w && a.max_h == b.max_h;
+    }
+
+    static void clearTree(Widget* w) {
+        w->clearDirty();
+        if (!w->isLayout()) return;
+        for (Widget* c = static_cast<Layout*>(w)->firstChild(); c; c = c->nextSibling()) clearTree(c);
+    }
+
+    // What the page's pixels depend on; 0 if any widget can't tell, or
+    // (`clean`) if a leaf has changes the panel does not show yet
+    static uint32_t pageHash(const Widget* w, bool clean = false) {
+        Hasher h;
+        return hashTree(w, h, clean) ? h.value() : 0;
+    }
+
+    static bool hashTree(const Widget* w, Hasher& h, bool clean) {
+        uint32_t c = w->contentHash();
+        if (c == 0 || (clean && !w->isLayout() && w->isDirty())) return false;
+        h.add(c).add(w->bounds()).add(w->isVisible());
+        if (!w->isLayout()) return true;
+        for (Widget* ch = static_cast<const Layout*>(w)->firstChild(); ch; ch = ch->nextSibling()) {
+            if (!hashTree(ch, h, clean)) return false;
+        }
+        return true;
+    }
+
+    PixelCache _pages[MAX_PAGES];
+    uint32_t _page_hash[MAX_PAGES] = {};
+    Constraints _measured_for;
+    Size _content;
+    OnChangeCallback _on_change = nullptr;
+    void* _user_data = nullptr;
+    UpdateHint _mode = UpdateHint::TEXT;
+    uint8_t _active = 0;
+    uint8_t _leaving = NO_PAGE;   // page to capture before the redraw
+    bool _measured = false;
+    bool _switching = false;
+    bool _cache = false;
+};
+
+} // namespace PaperUI
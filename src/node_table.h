@@ -0,0 +1,145 @@
+#pragma once
+
+#include "layout.h"
+
+#ifndef PAPERUI_MAX_NODES
+#define PAPERUI_MAX_NODES 128
+#endif
+
+namespace PaperUI {
+
+// Node flags
+enum : uint8_t {
+    NODE_VISIBLE = 0x01,   // widget and all ancestors visible
+    NODE_LAYOUT  = 0x02,
+    NODE_DIRTY   = 0x04,
+    NODE_BG      = 0x08,   // layout with a non-white background
+    NODE_TOUCH   = 0x10,   // widget handles touch (Widget::isInteractive)
+};
+
+// Flattened copy of the widget tree, in pre-order, as parallel arrays.
+//
+// Screen rebuilds it after layout and whenever Widget::tree_gen() moves, then
+// runs every traversal as a linear loop over these arrays instead of chasing
+// child pointers. Widgets keep their behavior (draw/onTouch/sync) and are
+// only dereferenced when a node actually needs work. `end[i]` is one past
+// the last descendant of i, so a whole subtree is skipped with `i = end[i]`.
+class NodeTable {
+public:
+    static constexpr uint16_t CAPACITY = PAPERUI_MAX_NODES;
+
+    // Table that Widget::markDirty() reports to
+    static NodeTable*& active() {
+        static NodeTable* t = nullptr;
+        return t;
+    }
+
+    void build(Widget* root) {
+        _count = 0;
+        _needed = 0;
+        _overflow = false;
+        _any_dirty = false;
+        if (root) add(root, NO_NODE, true);
+        active() = this;
+    }
+
+    void clear() {
+        _count = 0;
+        _any_dirty = false;
+    }
+
+    uint16_t size() const { return _count; }
+    bool overflowed() const { return _overflow; }
+    // Nodes the whole tree needs; more than CAPACITY when overflowed()
+    uint16_t needed() const { return _needed; }
+    bool anyDirty() const { return _any_dirty; }
+
+    void setDirty(uint16_t i, const Widget* w) {
+        if (i < _count && widget[i] == w) {
+            flags[i] |= NODE_DIRTY;
+            _any_dirty = true;
+        }
+    }
+
+    void clearDirty(uint16_t i) {
+        flags[i] &= ~NODE_DIRTY;
+        widget[i]->clearDirty();
+    }
+
+    void clearAllDirty() {
+        for (uint16_t i = 0; i < _count; i++) {
+            if (flags[i] & NODE_DIRTY) clearDirty(i);
+        }
+        _any_dirty = false;
+    }
+
+    bool isVisibleLeaf(uint16_t i) const {
+        return (flags[i] & (NODE_VISIBLE | NODE_LAYOUT)) == NODE_VISIBLE;
+    }
+
+    // --- Struct-of-arrays storage ---
+    Rect bounds[CAPACITY];
+    Widget* widget[CAPACITY];
+    uint16_t parent[CAPACITY];
+    uint16_t first_child[CAPACITY];
+    uint16_t next_sibling[CAPACITY];
+    uint16_t end[CAPACITY];
+    uint8_t flags[CAPACITY];
+    UpdateHint hint[CAPACITY];   // filled in for dirty leaves during collection
+
+private:
+    uint16_t add(Widget* w, uint16_t par, bool parent_visible) {
+        if (_count >= CAPACITY) {
+            _overflow = true;
+            _needed += countTree(w);
+            return NO_NODE;
+        }
+        _needed++;
+        uint16_t i = _count++;
+        bool vis = parent_visible && w->isVisible();
+
+        widget[i] = w;
+        bounds[i] = w->bounds();
+        parent[i] = par;
+        first_child[i] = NO_NODE;
+        next_sibling[i] = NO_NODE;
+        hint[i] = UpdateHint::NONE;
+        flags[i] = (vis ? NODE_VISIBLE : 0) | (w->isDirty() ? NODE_DIRTY : 0) |
+                   (w->isInteractive() ? NODE_TOUCH : 0);
+        if (w->isDirty()) _any_dirty = true;
+        w->_node = i;
+
+        if (w->isLayout()) {
+            Layout* lay = static_cast<Layout*>(w);
+            flags[i] |= NODE_LAYOUT;
+            if (lay->background() != Colors::WHITE) flags[i] |= NODE_BG;
+            uint16_t prev = NO_NODE;
+            for (Widget* c = lay->firstChild(); c; c = c->nextSibling()) {
+                uint16_t ci = add(c, i, vis);
+                if (ci == NO_NODE) continue;   // full: keep counting the rest
+                if (prev == NO_NODE) first_child[i] = ci;
+                else next_sibling[prev] = ci;
+                prev = ci;
+            }
+        }
+        end[i] = _count;
+        return i;
+    }
+
+    static uint16_t countTree(Widget* w) {
+        uint16_t n = 1;
+        if (w->isLayout()) {
+            for (Widget* c = static_cast<Layout*>(w)->firstChild(); c; c = c->nextSibling()) {
+                n += countTree(c);
+            }
+        }
+        return n;
+    }
+
+    uint16_t _count = 0;
+    uint16_t _needed = 0;
+    bool _overflow = false;
+    bool _any_dirty = false;
+};
+
+} // namespace PaperUI
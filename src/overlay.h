@@ -0,0 +1,91 @@
+#pragma once
+
+#include "layout.h"
+#include "pixel_cache.h"
+
+#ifndef PAPERUI_MAX_OVERLAYS
+#define PAPERUI_MAX_OVERLAYS 3
+#endif
+
+namespace PaperUI {
+
+enum class OverlayKind : uint8_t {
+    DIALOG,   // modal, centered; touches outside are swallowed
+    TOAST,    // bottom center, dismissed after a timeout; touches pass through
+    POPUP,    // below an anchor (dropdown); a touch outside dismisses it
+};
+
+// One entry of Screen's overlay layer: a widget tree laid out on its own,
+// drawn above the root inside a white, framed `area`, with the pixels it
+// covers kept in `under` so dismissing it is a copy back, not a redraw.
+struct Overlay {
+    static constexpr int16_t PAD = 8;      // frame + margin around the widget
+    static constexpr int16_t BORDER = 2;
+    static constexpr int16_t MARGIN = 16;  // from the screen edge
+
+    Widget* root = nullptr;
+    OverlayKind kind = OverlayKind::DIALOG;
+    Rect area;
+    uint32_t expires_at = 0;   // TOAST only
+    PixelCache under;
+
+    bool modal() const { return kind == OverlayKind::DIALOG; }
+
+    // Measure and place the tree; `anchor` positions a POPUP
+    void layout(const Rect& anchor) {
+        Constraints c(0, 0, SCREEN_W - 2 * (MARGIN + PAD), SCREEN_H - 2 * (MARGIN + PAD));
+        Size s = root->measure(c);
+        int16_t w = s.w + 2 * PAD;
+        int16_t h = s.h + 2 * PAD;
+        int16_t x = (SCREEN_W - w) / 2;
+        int16_t y = (SCREEN_H - h) / 2;
+        if (kind == OverlayKind::TOAST) {
+            y = SCREEN_H - MARGIN - h;
+        } else if (kind == OverlayKind::POPUP) {
+            x = anchor.x;
+            y = anchor.y + anchor.h;
+            if (y + h > SCREEN_H - MARGIN) y = anchor.y - h;   // no room below: open upwards
+            x = constrain(x, (int16_t)MARGIN, (int16_t)(SCREEN_W - MARGIN - w));
+            y = constrain(y, (int16_t)MARGIN, (int16_t)(SCREEN_H - MARGIN - h));
+        }
+        area = Rect(x, y, w, h);
+        root->setMeasuredSize(s);
+        root->place(x + PAD, y + PAD, s.w, s.h);
+        if (root->isLayout()) static_cast<Layout*>(root)->layout();
+    }
+
+    void draw(M5GFX& gfx) const {
+        gfx.fillRect(area.x, area.y, area.w, area.h, Colors::WHITE);
+        for (int16_t b = 0; b < BORDER; b++) {
+            gfx.drawRect(area.x + b, area.y + b, area.w - 2 * b, area.h - 2 * b, Colors::BLACK);
+        }
+        if (root->isVisible()) root->draw(gfx);
+    }
+
+    // Overlays hold no node table; their (small) trees are walked directly
+    static void syncTree(Widget* w) {
+        w->sync();
+        if (!w->isLayout()) return;
+        for (Widget* c = static_cast<Layout*>(w)->firstChild(); c; c = c->nextSibling()) syncTree(c);
+    }
+
+    static void clearTree(Widget* w) {
+        w->clearDirty();
+        if (!w->isLayout()) return;
+        for (Widget* c = static_cast<Layout*>(w)->firstChild(); c; c = c->nextSibling()) clearTree(c);
+    }
+
+    // Strongest update hint among dirty leaves
+    static UpdateHint dirtyHint(const Widget* w) {
+        if (!w->isDirty()) return UpdateHint::NONE;
+        if (!w->isLayout()) return w->updateHint();
+        UpdateHint h = UpdateHint::NONE;
+        for (Widget* c = static_cast<const Layout*>(w)->firstChild(); c; c = c->nextSibling()) {
+            UpdateHint ch = dirtyHint(c);
+            if ((uint8_t)ch > (uint8_t)h) h = ch;
+        }
+        return h;
+    }
+};
+
+} // namespace PaperUI
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "types.h"
+#include <esp_heap_caps.h>
+
+#ifndef PAPERUI_CACHE_BAND
+#define PAPERUI_CACHE_BAND 16
+#endif
+
+namespace PaperUI {
+
+// Copy of a panel region at 4 bits per pixel (the IT8951's native depth),
+// read back from the display framebuffer and written back on demand. Used
+// for whole pages (540x960 is 253 KB, PSRAM) and for the save-under of
+// overlays. Prefers PSRAM, falls back to internal RAM. Pixels move in
+// bands of PAPERUI_CACHE_BAND rows through a temporary buffer.
+class PixelCache {
+public:
+    static constexpr int16_t BAND = PAPERUI_CACHE_BAND;
+
+    PixelCache() = default;
+    PixelCache(const PixelCache&) = delete;
+    PixelCache& operator=(const PixelCache&) = delete;
+    ~PixelCache() { release(); }
+
+    bool valid() const { return _valid; }
+    void invalidate() { _valid = false; }
+    const Rect& area() const { return _area; }
+
+    // Frees the pixels; capture() allocates them again
+    void release() {
+        if (_pixels) heap_caps_free(_pixels);
+        _pixels = nullptr;
+        _capacity = 0;
+        _valid = false;
+    }
+
+    // Read `r` from the framebuffer. False if memory is short.
+    bool capture(M5GFX& gfx, const Rect& r = Rect(0, 0, SCREEN_W, SCREEN_H)) {
+        _valid = false;
+        _area = r;
+        uint32_t need = (uint32_t)stride() * r.h;
+        if (need > _capacity) {
+            release();
+            _pixels = static_cast<uint8_t*>(alloc(need));
+            if (!_pixels) return false;
+            _capacity = need;
+        }
+        _valid = read(gfx, r);
+        return _valid;
+    }
+
+    // Re-read the part of `r` inside the cached area, after what lies under
+    // it was redrawn
+    bool update(M5GFX& gfx, const Rect& r) {
+        if (!_valid) return false;
+        Rect part = r.intersect(_area);
+        if (part.area() == 0) return true;
+        _valid = read(gfx, part);
+        return _valid;
+    }
+
+    // Write the pixels back into the framebuffer; the caller pushes them
+    bool restore(M5GFX& gfx) const {
+        if (!_valid) return false;
+        lgfx::rgb565_t* band = static_cast<lgfx::rgb565_t*>(
+            alloc((size_t)_area.w * BAND * sizeof(lgfx::rgb565_t)));
+        if (!band) return false;
+        lgfx::rgb565_t levels[16];
+        for (uint8_t g = 0; g < 16; g++) levels[g] = lgfx::rgb565_t(g * 17, g * 17, g * 17);
+        for (int16_t y = 0; y < _area.h; y += BAND) {
+            int16_t h = min<int16_t>(_area.h - y, (int16_t)BAND);
+            lgfx::rgb565_t* out = band;
+            for (int16_t row = y; row < y + h; row++) {
+                const uint8_t* in = _pixels + (uint32_t)row * stride();
+                for (int16_t x = 0; x < _area.w; x++) {
+                    *out++ = levels[(x & 1) ? in[x >> 1] & 0x0F : in[x >> 1] >> 4];
+                }
+            }
+            gfx.pushImage(_area.x, _area.y + y, _area.w, h, band);
+        }
+        heap_caps_free(band);
+        return true;
+    }
+
+private:
+    static void* alloc(size_t n) {
+        void* p = heap_caps_malloc(n, MALLOC_CAP_SPIRAM);
+        return p ? p : heap_caps_malloc(n, MALLOC_CAP_8BIT);
+    }
+
+    static uint8_t gray4(const uint8_t* rgb) {
+        return (uint8_t)((rgb[0] * 77 + rgb[1] * 150 + rgb[2] * 29) >> 12);
+    }
+
+    uint16_t stride() const { return (uint16_t)((_area.w + 1) / 2); }
+
+    // `r` lies inside _area
+    bool read(M5GFX& gfx, const Rect& r) {
+        uint8_t* rgb = static_cast<uint8_t*>(alloc((size_t)r.w * BAND * 3));
+        if (!rgb) return false;
+        for (int16_t y = r.y; y < r.y + r.h; y += BAND) {
+            int16_t h = min<int16_t>(r.y + r.h - y, (int16_t)BAND);
+            gfx.readRectRGB(r.x, y, r.w, h, rgb);
+            const uint8_t* p = rgb;
+            for (int16_t row = y; row < y + h; row++) {
+                uint8_t* line = _pixels + (uint32_t)(row - _area.y) * stride();
+                for (int16_t x = r.x - _area.x; x < r.x - _area.x + r.w; x++, p += 3) {
+                    uint8_t& b = line[x >> 1];
+                    b = (x & 1) ? (uint8_t)((b & 0xF0) | gray4(p))
+                                : (uint8_t)((b & 0x0F) | gray4(p) << 4);
+                }
+            }
+        }
+        heap_caps_free(rgb);
+        return true;
+    }
+
+    uint8_t* _pixels = nullptr;
+    uint32_t _capacity = 0;
+    Rect _area;
+    bool _valid = false;
+};
+
+} // namespace PaperUI
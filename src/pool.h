@@ -1,27 +1,52 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
+#include <new>
 
 namespace PaperUI {
 
 template <typename T, uint16_t N>
 class StaticPool {
 public:
+    // A fresh object: a slot handed out before the last reset() is
+    // destroyed and constructed again, so no children, id or binding of
+    // the previous tree carry over.
     T& alloc() {
+        // Track demand even past capacity so the watermark shows the real need
+        if (_requested < UINT16_MAX) _requested++;
+        if (_requested > _peak) _peak = _requested;
         if (_count < N) {
-            return _items[_count++];
+            T& slot = _items[_count++];
+            slot.~T();
+            new (&slot) T();
+            return slot;
         }
         // Exhausted: reuse last slot (better than crashing)
         return _items[N - 1];
     }
 
-    void reset() { _count = 0; }
+    // Release all slots; alloc() reconstructs them as they are reused.
+    // Widgets from before stay valid until then. The high watermark
+    // survives so it covers every screen built since boot.
+    void reset() { _count = 0; _requested = 0; }
     uint16_t count() const { return _count; }
     static constexpr uint16_t capacity() { return N; }
 
+    // Highest number of slots requested between two reset() calls.
+    // Greater than capacity() means widgets were aliased.
+    uint16_t peak() const { return _peak; }
+    bool overflowed() const { return _peak > N; }
+    void clearPeak() { _peak = _requested; }
+
+    static constexpr size_t itemSize() { return sizeof(T); }
+    static constexpr size_t footprint() { return sizeof(T) * N; }
+
 private:
     T _items[N];
     uint16_t _count = 0;
+    uint16_t _requested = 0;
+    uint16_t _peak = 0;
 };
 
 } // namespace PaperUI
@@ -1,6 +1,17 @@
 #pragma once
 
 #include "layout.h"
+#include "node_table.h"
+#include "touch_grid.h"
+#include "id_index.h"
+#include "gesture.h"
+#include "touch_sampler.h"
+#include "idle.h"
+#include "snapshot.h"
+#include "trace.h"
+#include "energy.h"
+#include "pixel_cache.h"
+#include "overlay.h"
 #include "state.h"
 
 #ifdef PAPERUI_DEBUG
@@ -12,9 +23,6 @@
 namespace PaperUI {
 
 constexpr uint8_t MAX_DIRTY_RECTS = 8;
-constexpr int16_t SCREEN_W = 540;
-constexpr int16_t SCREEN_H = 960;
-constexpr unsigned long TOUCH_DEBOUNCE_MS = 80;
 constexpr uint16_t DEFAULT_FULL_REFRESH_INTERVAL = 10;
 
 class Screen {
@@ -26,46 +34,273 @@ public:
         _gfx->setAutoDisplay(false);
     }
 
-    void setRoot(Layout* root) { _root = root; }
+    // Root may be a Layout or a single widget (e.g. a StaticRoot tree).
+    void setRoot(Widget* root) { _root = root; rebuildNodes(); }
 
-    void root(Layout& r) { setRoot(&r); performLayout(); }
+    // False if the tree does not fit the node table (see nodesOverflowed())
+    bool root(Widget& r) {
+        setRoot(&r);
+        performLayout();
+        return !_nodes.overflowed();
+    }
+
+    // Nodes past PAPERUI_MAX_NODES are not drawn, synced or touchable.
+    // nodesNeeded() is what the current tree would take.
+    bool nodesOverflowed() const { return _nodes.overflowed(); }
+    uint16_t nodesNeeded() const { return _nodes.needed(); }
 
     // Full layout pass: measure -> place -> layout -> draw -> push.
     void performLayout() {
         if (!_root || !_gfx) return;
-        Constraints sc(SCREEN_W, SCREEN_H, SCREEN_W, SCREEN_H);
-        _root->measure(sc);
-        _root->place(0, 0, SCREEN_W, SCREEN_H);
-        _root->layout();
+        syncBindings();   // bound values can change sizes
+        layoutTree();
         // Full initial render
         _gfx->fillScreen(Colors::WHITE);
-        _root->draw(*_gfx);
-        _gfx->setEpdMode(epd_mode_t::epd_quality);
-        _gfx->display();
-        clearAllDirty(_root);
+        redrawRegion(Rect(0, 0, SCREEN_W, SCREEN_H));
+        paintOverlays(Rect(0, 0, SCREEN_W, SCREEN_H), 0);
+        pushDirtyRect(Rect(0, 0, SCREEN_W, SCREEN_H), epd_mode_t::epd_quality);
+        _stats.full_refreshes++;
+        _nodes.clearAllDirty();
     }
 
     // Call every loop() iteration. Syncs state bindings, processes input, re-renders dirty regions.
     void update() {
-        if (StateBase::global_gen() != _last_synced_gen) {
-            syncAll(_root);
-            _last_synced_gen = StateBase::global_gen();
-        }
+        if (!_root) return;
+        bool woke = WakeSchedule::expire(millis());
+        if (Widget::tree_gen() != _tree_gen) rebuildNodes();
+        // A passed deadline may be a binding waiting to deliver its latest value
+        if (StateBase::global_gen() != _last_synced_gen || woke) syncBindings();
+        _touch_frame = false;
         processTouch();
         processButtons();
+        expireOverlays();
+        render();
+        renderOverlays();
+    }
+
+    // Record what the panel shows, for restore() after deep sleep. Call
+    // after update() has pushed everything; fails if work is pending or the
+    // tree exceeds the snapshot.
+    bool saveSnapshot(UiSnapshot& snap) const {
+        snap.invalidate();
+        if (!_root || _nodes.anyDirty()) return false;
+        return snap.capture(_nodes, _partial_count);
+    }
+
+    // Like root(), for a panel that still shows `snap` (e.g. after deep
+    // sleep): lays out and syncs the tree, then redraws and pushes only
+    // nodes whose bounds or content differ, at both old and new bounds. No
+    // fillScreen, no full GC16. Falls back to root() for an invalid
+    // snapshot and returns false.
+    bool restore(Widget& r, const UiSnapshot& snap) {
+        setRoot(&r);
+        if (!_gfx) return false;
+        if (!snap.valid()) {
+            performLayout();
+            return false;
+        }
+        syncBindings();
+        layoutTree();
+        _nodes.clearAllDirty();
+        uint16_t changed = invalidateChanges(snap);
+        PUI_LOG("restore: %u of %u nodes changed", changed, _nodes.size());
+        (void)changed;
+        _partial_count = snap.partial_count;
         render();
+        return true;
+    }
+
+    // Rebuilding a screen in place:
+    //
+    //   screen.beginRebuild();      // before ui::reset()
+    //   ui::reset();
+    //   screen.reconcile(buildSettings());
+    //
+    // The new tree is matched against the old one (by id, else by position
+    // under a matched parent) and only what differs is redrawn and pushed.
+    // Without beginRebuild() (or if the old tree did not fit a UiSnapshot)
+    // reconcile() is root() and returns false.
+    void beginRebuild() {
+        _prev.invalidate();
+        if (_root) _prev.capture(_nodes, _partial_count);
+    }
+
+    bool reconcile(Widget& r) {
+        bool ok = _prev.valid() && _root;
+        if (ok) {
+            ok = restore(r, _prev);
+        } else {
+            root(r);
+        }
+        _prev.invalidate();
+        return ok;
+    }
+
+    // Show a tree that was laid out before (a retained page) without
+    // measuring or laying it out again. With a valid `cache` the panel image
+    // is written back and only widgets changed since are redrawn on top;
+    // otherwise the page is redrawn. Either way it goes out in one push.
+    void resume(Widget& r, const PixelCache* cache = nullptr) {
+        setRoot(&r);
+        if (!_gfx) return;
+        syncBindings();
+        Rect full(0, 0, SCREEN_W, SCREEN_H);
+        if (cache && cache->restore(*_gfx)) {
+            collectDirtyRects();
+            for (uint8_t k = 0; k < _dirty_count; k++) {
+                const Rect& d = _dirty_rects[k];
+                _gfx->fillRect(d.x, d.y, d.w, d.h, Colors::WHITE);
+                redrawRegion(d);
+            }
+            _dirty_count = 0;
+        } else {
+            _gfx->fillScreen(Colors::WHITE);
+            redrawRegion(full);
+        }
+        paintOverlays(full, 0);
+        pushDirtyRect(full, epd_mode_t::epd_quality);
+        _stats.full_refreshes++;
+        _partial_count = 0;
+        _nodes.clearAllDirty();
+    }
+
+    // Milliseconds until update() next has work: 0 if something is pending
+    // now (dirty widgets, unsynced state, queued or held touch), the time to
+    // the earliest requestWakeAt() deadline, or IDLE_FOREVER if only input
+    // can change anything.
+    uint32_t nextWakeIn(uint32_t now) const {
+        if (!_root) return IDLE_FOREVER;
+        if (Widget::tree_gen() != _tree_gen ||
+            StateBase::global_gen() != _last_synced_gen ||
+            (_nodes.anyDirty() && !budgetHolding()) || overlayDirty() || _gestures.isDown() ||
+            (_sampler.running() && !_sampler.queue().empty())) {
+            return 0;
+        }
+        if (!WakeSchedule::pending()) return IDLE_FOREVER;
+        int32_t left = (int32_t)(WakeSchedule::deadline() - now);
+        return left > 0 ? (uint32_t)left : 0;
+    }
+
+    // Call at the end of loop(). Light-sleeps until the next deadline or a
+    // touch/button wake, or returns BUSY at once if there is work to do.
+    IdleResult idle() {
+        uint32_t ms = nextWakeIn(millis());
+        if (ms > _idle.max_sleep_ms) ms = _idle.max_sleep_ms;
+        if (ms < _idle.min_sleep_ms) return IdleResult::BUSY;
+        if (_gfx) _gfx->waitDisplay();   // the panel transfer must finish before the bus stops
+        IdleResult r = lightSleep(_idle, ms);
+        PUI_LOG("idle %lu ms -> %s", (unsigned long)ms,
+                r == IdleResult::TIMER ? "timer" : r == IdleResult::INPUT ? "input" : "busy");
+        return r;
     }
 
+    // Wake pins and sleep limits used by idle()
+    IdleConfig& idleConfig() { return _idle; }
+
     // Force a full-quality refresh (clears ghosting)
     void fullRefresh() {
         if (!_gfx || !_root) return;
         _gfx->fillScreen(Colors::WHITE);
-        _root->draw(*_gfx);
-        _gfx->setEpdMode(epd_mode_t::epd_quality);
-        _gfx->display();
+        redrawRegion(Rect(0, 0, SCREEN_W, SCREEN_H));
+        paintOverlays(Rect(0, 0, SCREEN_W, SCREEN_H), 0);
+        pushDirtyRect(Rect(0, 0, SCREEN_W, SCREEN_H), epd_mode_t::epd_quality);
+        _stats.full_refreshes++;
         _partial_count = 0;
     }
 
+    // --- Overlays ---
+    //
+    // Trees shown above the root without joining it: laid out on their own,
+    // drawn in a white frame, and on dismiss the pixels they covered are
+    // copied back (save-under) and only their rect is pushed. Up to
+    // PAPERUI_MAX_OVERLAYS at once; the last shown is on top.
+
+    bool showDialog(Widget& w) { return showOverlay(w, OverlayKind::DIALOG); }
+    bool showToast(Widget& w, uint32_t ms = 3000) { return showOverlay(w, OverlayKind::TOAST, Rect(), ms); }
+    bool showPopup(Widget& w, const Rect& anchor) { return showOverlay(w, OverlayKind::POPUP, anchor); }
+
+    bool showOverlay(Widget& w, OverlayKind kind, const Rect& anchor = Rect(), uint32_t timeout_ms = 0) {
+        if (!_gfx || _overlay_count >= PAPERUI_MAX_OVERLAYS || overlayIndex(&w) >= 0) return false;
+        uint8_t slot = 0;
+        while (_overlays[slot].root) slot++;
+        Overlay& o = _overlays[slot];
+        o.root = &w;
+        o.kind = kind;
+        o.expires_at = 0;
+        if (timeout_ms) {
+            o.expires_at = millis() + timeout_ms;
+            requestWakeAt(o.expires_at);
+        }
+        Overlay::syncTree(&w);
+        o.layout(anchor);
+        if (!o.under.capture(*_gfx, o.area)) {
+            PUI_LOG("overlay: no memory for save-under, will redraw on dismiss");
+        }
+        _overlay_order[_overlay_count++] = slot;
+        if (o.modal()) _captured = nullptr;
+        o.draw(*_gfx);
+        Overlay::clearTree(&w);
+        pushDirtyRect(o.area, epd_mode_t::epd_text);
+        return true;
+    }
+
+    bool dismissOverlay(Widget& w) {
+        int8_t k = overlayIndex(&w);
+        if (k < 0) return false;
+        dismissAt((uint8_t)k);
+        return true;
+    }
+
+    // Topmost
+    bool dismissOverlay() {
+        if (!_overlay_count) return false;
+        dismissAt(_overlay_count - 1);
+        return true;
+    }
+
+    uint8_t overlayCount() const { return _overlay_count; }
+    Widget* topOverlay() const {
+        return _overlay_count ? _overlays[_overlay_order[_overlay_count - 1]].root : nullptr;
+    }
+
+    // Read `r` of the page into `pc` without the overlays on it: their
+    // save-unders are written back for the copy, then they are drawn
+    // again (nothing is pushed). False, with `pc` invalid, if memory is
+    // short or an overlay has no save-under.
+    bool capturePage(PixelCache& pc, const Rect& r = Rect(0, 0, SCREEN_W, SCREEN_H)) {
+        if (!_gfx) return false;
+        bool covered = overOverlay(r);
+        bool clean = true;
+        if (covered) {
+            for (uint8_t k = _overlay_count; k-- > 0;) {
+                if (!_overlays[_overlay_order[k]].under.restore(*_gfx)) clean = false;
+            }
+        }
+        bool ok = clean && pc.capture(*_gfx, r);
+        if (!ok) pc.invalidate();
+        if (covered) {
+            for (uint8_t k = 0; k < _overlay_count; k++) _overlays[_overlay_order[k]].draw(*_gfx);
+        }
+        return ok;
+    }
+
+    // Gestures no widget consumed (e.g. swipe between pages)
+    void setOnGesture(OnGestureCallback cb, void* d = nullptr) {
+        _on_gesture = cb; _gesture_data = d;
+    }
+
+    // Tap/drag/long-press thresholds and MOVE coalescing step
+    GestureConfig& gestureConfig() { return _gestures.config(); }
+
+    // Sample touch on a background task instead of polling M5.Touch from
+    // update(), so taps made while display() blocks are queued, not lost.
+    // The task reads the controller itself; don't read M5.Touch meanwhile.
+    bool startTouchTask(uint16_t period_ms = 10, uint8_t core = 0) {
+        return _sampler.start(period_ms, core);
+    }
+    void stopTouchTask() { _sampler.stop(); }
+    TouchSampler& touchSampler() { return _sampler; }
+
     // Set how many partial updates before an automatic full refresh.
     // 0 disables automatic full refresh.
     void setFullRefreshInterval(uint16_t n) { _full_refresh_interval = n; }
@@ -83,40 +318,223 @@ public:
 
     M5GFX& gfx() { return *_gfx; }
 
+    // Flattened tree used by all traversals (valid after performLayout)
+    const NodeTable& nodes() const { return _nodes; }
+
+    // Widget in the current tree with Widget::id == id, or nullptr. The
+    // index is built on the first lookup after a tree change, so ids must
+    // be set before then (a stale hit is caught and rebuilt, a stale miss
+    // is not). 0 is never found.
+    Widget* find(uint16_t id) {
+        if (_root && Widget::tree_gen() != _tree_gen) rebuildNodes();
+        for (uint8_t attempt = 0; attempt < 2; attempt++) {
+            if (_ids_stale) buildIdIndex();
+            uint16_t n = _ids.lookup(id);
+            if (n == NO_NODE) return nullptr;
+            if (_nodes.widget[n]->id == id) return _nodes.widget[n];
+            _ids_stale = true;   // id changed since the index was built
+        }
+        return nullptr;
+    }
+
+    // No RTTI on the target: the caller vouches for the type
+    template <typename T>
+    T* find(uint16_t id) { return static_cast<T*>(find(id)); }
+
+    // Limit e-ink energy to `per_hour` full-GC16 equivalents, with up to
+    // `burst` spent back to back; 0 turns the governor off. When the budget
+    // is short, non-urgent changes wait, accumulate and go out together
+    // (merged when that is cheaper). URGENT widgets and touch feedback are
+    // always pushed at once.
+    void setRefreshBudget(float per_hour, float burst = 3) {
+        _budget.setRefreshesPerHour(per_hour, burst, _energy);
+    }
+
+    // Cost weights used by the budget and ScreenStats::energy
+    EnergyModel& energyModel() { return _energy; }
+    const EnergyBudget& budget() const { return _budget; }
+
+    // Render counters; per-widget ones are on Widget::stats() when built
+    // with PAPERUI_WIDGET_STATS
+    const ScreenStats& stats() const { return _stats; }
+
+    void resetStats() {
+        _stats = ScreenStats();
+#ifdef PAPERUI_WIDGET_STATS
+        for (uint16_t i = 0; i < _nodes.size(); i++) _nodes.widget[i]->stats() = WidgetStats();
+#endif
+    }
+
+    // Global counters, then (with PAPERUI_WIDGET_STATS) every leaf that
+    // drew or pushed since the reset
+    void dumpStats(Print& out = Serial) const {
+        out.printf("[PUI] stats frames=%lu partials=%lu full=%lu merged=%lu dropped=%lu "
+                   "deferred=%lu energy=%llu\n",
+                   (unsigned long)_stats.frames, (unsigned long)_stats.partials,
+                   (unsigned long)_stats.full_refreshes, (unsigned long)_stats.merged_rects,
+                   (unsigned long)_stats.dropped_rects, (unsigned long)_stats.deferred_frames,
+                   (unsigned long long)_stats.energy);
+        out.printf("[PUI] stats nodes=%u needed=%u cap=%u%s\n", _nodes.size(), _nodes.needed(),
+                   NodeTable::CAPACITY, _nodes.overflowed() ? " OVERFLOW" : "");
+        out.printf("[PUI] stats px");
+        for (uint8_t m = 0; m < EPD_SLOTS; m++) {
+            out.printf(" %s=%lu", epdSlotName(m), (unsigned long)_stats.pixels[m]);
+        }
+        out.printf("\n");
+#ifdef PAPERUI_WIDGET_STATS
+        for (uint16_t i = 0; i < _nodes.size(); i++) {
+            const WidgetStats& ws = _nodes.widget[i]->stats();
+            if (ws.draws == 0 && ws.pushes == 0) continue;
+            out.printf("[PUI] widget node=%u id=%u (%d,%d %dx%d) draws=%lu avg_us=%lu pushes=%lu px",
+                       i, _nodes.widget[i]->id,
+                       _nodes.bounds[i].x, _nodes.bounds[i].y,
+                       _nodes.bounds[i].w, _nodes.bounds[i].h,
+                       (unsigned long)ws.draws,
+                       (unsigned long)(ws.draws ? ws.draw_us / ws.draws : 0),
+                       (unsigned long)ws.pushes);
+            for (uint8_t m = 0; m < EPD_SLOTS; m++) {
+                out.printf(" %s=%lu", epdSlotName(m), (unsigned long)ws.pixels[m]);
+            }
+            out.printf("\n");
+        }
+#endif
+    }
+
 private:
     // --- Input ---
 
     void processTouch() {
         if (!_root) return;
-
-        // Debounce: skip touch entirely during cooldown
-        if (_debounce_until) {
-            if (millis() < _debounce_until) return;
-            _debounce_until = 0;
+        if (_sampler.running()) {
+            drainTouchQueue();
+            return;
         }
+        bool down = M5.Touch.getCount() > 0;
+        if (!down && !_gestures.isDown()) return;
 
-        auto count = M5.Touch.getCount();
-        if (count > 0) {
+        TouchSample sample(0, 0, millis(), down);
+        if (down) {
             auto t = M5.Touch.getDetail(0);
-            TouchEvent ev;
-            ev.x = t.x;
-            ev.y = t.y;
-            ev.action = _touch_active ? TouchAction::MOVE : TouchAction::DOWN;
-            _touch_active = true;
-            _last_x = t.x;
-            _last_y = t.y;
-            PUI_LOG("touch %s (%d,%d)", ev.action == TouchAction::DOWN ? "DOWN" : "MOVE", ev.x, ev.y);
-            _root->onTouch(ev);
-        } else if (_touch_active) {
-            _touch_active = false;
-            _debounce_until = millis() + TOUCH_DEBOUNCE_MS;
-            TouchEvent ev;
-            ev.x = _last_x;
-            ev.y = _last_y;
-            ev.action = TouchAction::UP;
-            PUI_LOG("touch UP (%d,%d)", ev.x, ev.y);
-            _root->onTouch(ev);
+            sample.x = t.x;
+            sample.y = t.y;
         }
+        handleSample(sample);
+    }
+
+    // Replay queued samples in order. Runs of MOVE samples collapse to the
+    // last one; DOWN and UP are always delivered.
+    void drainTouchQueue() {
+        TouchQueue& q = _sampler.queue();
+        TouchSample s, next;
+        bool have = q.pop(s);
+        while (have) {
+            bool more = q.pop(next);
+            bool folded = more && s.down && next.down && _gestures.isDown();
+            handleSample(s, !folded);
+            s = next;
+            have = more;
+        }
+        // A still finger queues nothing; keep long press timing alive
+        if (_gestures.isDown()) handleResult(_gestures.poll(millis()));
+    }
+
+    void handleSample(const TouchSample& sample, bool deliver_move = true) {
+        PUI_TRACE_SCOPE(TOUCH);
+        handleResult(_gestures.feed(sample, deliver_move));
+    }
+
+    void handleResult(const GestureResult& r) {
+        if (r.has_raw || r.count) _touch_frame = true;
+        if (r.has_raw) {
+            PUI_LOG("touch %s (%d,%d)",
+                    r.raw.action == TouchAction::DOWN ? "DOWN" :
+                    r.raw.action == TouchAction::MOVE ? "MOVE" : "UP",
+                    r.raw.x, r.raw.y);
+            if (r.raw.action == TouchAction::DOWN) _gesture_target = nullptr;
+            dispatchTouch(r.raw);
+            if (r.raw.action == TouchAction::DOWN) {
+                _gesture_target = _captured ? _captured
+                                : _overlay_touch ? nullptr : deepestAt(r.raw.x, r.raw.y);
+            }
+        }
+        for (uint8_t i = 0; i < r.count; i++) {
+            dispatchGesture(r.events[i]);
+        }
+    }
+
+    void dispatchGesture(const GestureEvent& g) {
+        for (Widget* w = _gesture_target; w; w = w->parent()) {
+            if (w->onGesture(g)) return;
+        }
+        if (_on_gesture && !modalOverlay()) _on_gesture(_gesture_data, g);
+    }
+
+    // Deepest visible node containing the point (last match in pre-order)
+    Widget* deepestAt(int16_t x, int16_t y) const {
+        for (uint16_t i = _nodes.size(); i-- > 0;) {
+            if ((_nodes.flags[i] & NODE_VISIBLE) && _nodes.bounds[i].contains(x, y)) {
+                return _nodes.widget[i];
+            }
+        }
+        return nullptr;
+    }
+
+    bool dispatchTouch(const TouchEvent& ev) {
+        // MOVE/UP go straight to the widget that consumed DOWN, even when
+        // the finger has left its bounds.
+        if (_captured && ev.action != TouchAction::DOWN) {
+            Widget* w = _captured;
+            if (ev.action == TouchAction::UP) _captured = nullptr;
+            return w->onTouch(ev);
+        }
+        _overlay_touch = false;
+        if (dispatchToOverlays(ev)) {
+            _overlay_touch = true;
+            return true;
+        }
+        Widget* target = hitTest(ev);
+        if (ev.action == TouchAction::DOWN) _captured = target;
+        return target != nullptr;
+    }
+
+    // Topmost first. A touch inside an overlay goes to its tree; outside,
+    // a dialog swallows it, a popup closes (and swallows it), a toast lets
+    // it through. A toast lets through touches inside it too, unless its
+    // tree consumes them.
+    bool dispatchToOverlays(const TouchEvent& ev) {
+        for (uint8_t k = _overlay_count; k-- > 0;) {
+            Overlay& o = _overlays[_overlay_order[k]];
+            if (o.kind == OverlayKind::TOAST) {
+                if (!o.area.contains(ev.x, ev.y) || !o.root->onTouch(ev)) continue;
+                if (ev.action == TouchAction::DOWN) _captured = o.root;
+                return true;
+            }
+            if (o.area.contains(ev.x, ev.y)) {
+                if (ev.action == TouchAction::DOWN) _captured = o.root;
+                o.root->onTouch(ev);
+                return true;
+            }
+            if (o.kind == OverlayKind::POPUP) {
+                if (ev.action == TouchAction::DOWN) dismissAt(k);
+                return true;
+            }
+            if (o.modal()) return true;
+        }
+        return false;
+    }
+
+    // Offer the event to the interactive leaves under the point, topmost
+    // first (matching Layout::onTouch). Returns the widget that consumed it.
+    Widget* hitTest(const TouchEvent& ev) {
+        const uint16_t* begin;
+        const uint16_t* end;
+        if (!_touch_grid.cellAt(ev.x, ev.y, begin, end)) return nullptr;
+        for (const uint16_t* p = end; p-- != begin;) {
+            if (!_nodes.bounds[*p].contains(ev.x, ev.y)) continue;
+            Widget* w = _nodes.widget[*p];
+            if (w->onTouch(ev)) return w;
+        }
+        return nullptr;
     }
 
     void processButtons() {
@@ -127,24 +545,241 @@ private:
 
     // --- Rendering ---
 
+    // measure -> place -> layout, then flatten
+    void layoutTree() {
+        Constraints sc(SCREEN_W, SCREEN_H, SCREEN_W, SCREEN_H);
+        PUI_TRACE_BEGIN(MEASURE);
+        _root->measure(sc);
+        PUI_TRACE_END(MEASURE);
+        PUI_TRACE_SCOPE(LAYOUT);
+        _root->place(0, 0, SCREEN_W, SCREEN_H);
+        if (_root->isLayout()) static_cast<Layout*>(_root)->layout();
+        rebuildNodes();
+    }
+
+    void rebuildNodes() {
+        _nodes.build(_root);
+        _touch_grid.build(_nodes);
+        _ids_stale = true;
+        _tree_gen = Widget::tree_gen();
+        // Drop touch targets that left the tree
+        if (!inTree(_captured)) _captured = nullptr;
+        if (!inTree(_gesture_target)) _gesture_target = nullptr;
+        // Not behind PAPERUI_DEBUG: part of the UI would silently vanish.
+        // Once per tree size, not on every rebuild.
+        if (_nodes.overflowed() && _nodes.needed() != _overflow_warned) {
+            Serial.printf("[PUI] node table full: tree has %u nodes, %u shown; "
+                          "raise PAPERUI_MAX_NODES\n", _nodes.needed(), NodeTable::CAPACITY);
+        }
+        _overflow_warned = _nodes.overflowed() ? _nodes.needed() : 0;
+        if (_touch_grid.overflowed()) {
+            PUI_LOG("touch grid full (%u), raise PAPERUI_TOUCH_GRID_ENTRIES", TouchGrid::CAPACITY);
+        }
+    }
+
+    void buildIdIndex() {
+        _ids.build(_nodes);
+        _ids_stale = false;
+        if (_ids.duplicates()) {
+            PUI_LOG("%u duplicate widget ids, first in tree order wins", _ids.duplicates());
+        }
+        if (_ids.overflowed()) {
+            PUI_LOG("id index full (%u), raise PAPERUI_ID_INDEX_SLOTS", IdIndex::SLOTS);
+        }
+    }
+
+    // Mark what differs from `snap`: a matched leaf with the same bounds is
+    // redrawn in place; anything that moved, appeared or went away adds its
+    // old and new bounds as dirty rects. Plain (white) layouts draw nothing
+    // themselves and are covered by their children. Returns nodes changed.
+    uint16_t invalidateChanges(const UiSnapshot& snap) {
+        uint16_t match[NodeTable::CAPACITY];
+        uint8_t seen[(UiSnapshot::CAPACITY + 7) / 8] = {};
+        snap.match(_nodes, match);
+        uint16_t changed = 0;
+        for (uint16_t i = 0; i < _nodes.size(); i++) {
+            uint16_t m = match[i];
+            bool same_place = false;
+            if (m != NO_NODE) {
+                seen[m >> 3] |= 1 << (m & 7);
+                same_place = UiSnapshot::rect(snap.bounds[m]) == _nodes.bounds[i];
+                uint32_t h = UiSnapshot::nodeHash(_nodes, i);
+                if (same_place && h != 0 && h == snap.hash[m]) continue;
+            }
+            changed++;
+            if (same_place && _nodes.isVisibleLeaf(i)) {
+                _nodes.widget[i]->markDirty();   // same place, new content
+                continue;
+            }
+            bool is_layout = _nodes.flags[i] & NODE_LAYOUT;
+            if (m != NO_NODE && (snap.flags[m] & NODE_VISIBLE) &&
+                (!is_layout || (snap.flags[m] & NODE_BG))) {
+                addStaleRect(UiSnapshot::rect(snap.bounds[m]));
+            }
+            if ((_nodes.flags[i] & NODE_VISIBLE) && (!is_layout || (_nodes.flags[i] & NODE_BG))) {
+                addStaleRect(_nodes.bounds[i]);
+            }
+        }
+        for (uint16_t j = 0; j < snap.count; j++) {
+            if (seen[j >> 3] & (1 << (j & 7))) continue;
+            changed++;
+            bool plain_layout = (snap.flags[j] & (NODE_LAYOUT | NODE_BG)) == NODE_LAYOUT;
+            if ((snap.flags[j] & NODE_VISIBLE) && !plain_layout) {
+                addStaleRect(UiSnapshot::rect(snap.bounds[j]));
+            }
+        }
+        return changed;
+    }
+
+    // Overlapping stale areas are pushed once
+    void addStaleRect(const Rect& r) {
+        for (uint8_t k = 0; k < _dirty_count; k++) {
+            if (_dirty_rects[k].intersects(r)) {
+                _dirty_rects[k] = _dirty_rects[k].unite(r);
+                return;
+            }
+        }
+        addDirtyRect(r);
+    }
+
+    // --- Overlay layer ---
+
+    int8_t overlayIndex(const Widget* w) const {
+        for (uint8_t k = 0; k < _overlay_count; k++) {
+            if (_overlays[_overlay_order[k]].root == w) return (int8_t)k;
+        }
+        return -1;
+    }
+
+    bool modalOverlay() const {
+        for (uint8_t k = 0; k < _overlay_count; k++) {
+            if (_overlays[_overlay_order[k]].modal()) return true;
+        }
+        return false;
+    }
+
+    bool overlayDirty() const {
+        for (uint8_t k = 0; k < _overlay_count; k++) {
+            if (_overlays[_overlay_order[k]].root->isDirty()) return true;
+        }
+        return false;
+    }
+
+    bool overOverlay(const Rect& r) const {
+        for (uint8_t k = 0; k < _overlay_count; k++) {
+            if (_overlays[_overlay_order[k]].area.intersects(r)) return true;
+        }
+        return false;
+    }
+
+    bool underOverlay(const Rect& r) const {
+        for (uint8_t k = 0; k < _overlay_count; k++) {
+            const Rect& a = _overlays[_overlay_order[k]].area;
+            if (a.unite(r) == a) return true;
+        }
+        return false;
+    }
+
+    // Something below overlays `from`.. was redrawn in `r`: refresh their
+    // save-under from the framebuffer, then draw them back on top. Each
+    // redrawn overlay widens the region for the ones above it.
+    void paintOverlays(Rect r, uint8_t from) {
+        for (uint8_t k = from; k < _overlay_count; k++) {
+            Overlay& o = _overlays[_overlay_order[k]];
+            if (!o.area.intersects(r)) continue;
+            o.under.update(*_gfx, r);
+            o.draw(*_gfx);
+            r = r.unite(o.area);
+        }
+    }
+
+    void dismissAt(uint8_t k) {
+        Overlay& o = _overlays[_overlay_order[k]];
+        Rect a = o.area;
+        bool restored = o.under.restore(*_gfx);
+        if (!restored) {
+            _gfx->fillRect(a.x, a.y, a.w, a.h, Colors::WHITE);
+            redrawRegion(a);
+        }
+        if (_captured == o.root) _captured = nullptr;
+        if (_gesture_target == o.root) _gesture_target = nullptr;
+        o.root = nullptr;
+        o.under.invalidate();
+        for (uint8_t j = k; j + 1 < _overlay_count; j++) _overlay_order[j] = _overlay_order[j + 1];
+        _overlay_count--;
+        paintOverlays(a, restored ? k : 0);
+        pushDirtyRect(a, epd_mode_t::epd_text);
+    }
+
+    void expireOverlays() {
+        uint32_t now = millis();
+        for (uint8_t k = _overlay_count; k-- > 0;) {
+            const Overlay& o = _overlays[_overlay_order[k]];
+            if (o.expires_at && (int32_t)(now - o.expires_at) >= 0) dismissAt(k);
+        }
+    }
+
+    // Overlays whose own widgets changed: redraw the whole (small) tree
+    // and push its rect once, in the mode its dirty leaves ask for
+    void renderOverlays() {
+        for (uint8_t k = 0; k < _overlay_count; k++) {
+            Overlay& o = _overlays[_overlay_order[k]];
+            if (!o.root->isDirty()) continue;
+            UpdateHint hint = Overlay::dirtyHint(o.root);
+            o.draw(*_gfx);
+            paintOverlays(o.area, k + 1);
+            Overlay::clearTree(o.root);
+            pushDirtyRect(o.area, modeForHint(hint == UpdateHint::NONE ? UpdateHint::FAST : hint));
+        }
+    }
+
+    bool inTree(const Widget* w) const {
+        if (!w) return false;
+        uint16_t n = w->node();
+        return n < _nodes.size() && _nodes.widget[n] == w;
+    }
+
+    // Rects already in _dirty_rects (from restore()) are drawn as well.
     void render() {
-        _dirty_count = 0;
-        collectDirtyRects(_root);
-        if (_dirty_count == 0) return;
+        // A touch handler may have changed visibility (page switch) this frame
+        if (Widget::tree_gen() != _tree_gen) rebuildNodes();
+        if (!_nodes.anyDirty() && _dirty_count == 0) return;
+        if (deferForBudget()) return;
+        PUI_TRACE_SCOPE(FRAME);
+        collectDirtyRects();
+        if (_dirty_count == 0) {
+            _nodes.clearAllDirty();
+            return;
+        }
+        beforePaint();
 
         PUI_LOG("render: %d dirty rects", _dirty_count);
 
         // Merge if too fragmented
         if (_dirty_count > MAX_DIRTY_RECTS / 2) {
+            PUI_TRACE_SCOPE(MERGE);
             Rect merged = _dirty_rects[0];
             for (uint8_t i = 1; i < _dirty_count; i++) {
                 merged = merged.unite(_dirty_rects[i]);
             }
             _dirty_rects[0] = merged;
+            _stats.merged_rects += _dirty_count - 1;
             _dirty_count = 1;
             PUI_LOG("  merged to (%d,%d %dx%d)", merged.x, merged.y, merged.w, merged.h);
         }
 
+        // Pick EPD modes while the dirty flags still say what changed
+        epd_mode_t modes[MAX_DIRTY_RECTS];
+        for (uint8_t r = 0; r < _dirty_count; r++) {
+            modes[r] = selectEpdMode(_dirty_rects[r]);
+        }
+        if (_budget.enabled()) coalesceForCost(modes);
+        for (uint8_t r = 0; r < _dirty_count; r++) {
+            chargePush(_dirty_rects[r], modes[r]);
+        }
+        _deferring = false;
+        _stats.frames++;
+
         // Clear and redraw widgets overlapping each dirty rect
         for (uint8_t r = 0; r < _dirty_count; r++) {
             PUI_LOG("  push rect[%d]: (%d,%d %dx%d)", r,
@@ -152,15 +787,18 @@ private:
                     _dirty_rects[r].w, _dirty_rects[r].h);
             _gfx->fillRect(_dirty_rects[r].x, _dirty_rects[r].y,
                            _dirty_rects[r].w, _dirty_rects[r].h, Colors::WHITE);
-            redrawRegion(_root, _dirty_rects[r]);
+            redrawRegion(_dirty_rects[r]);
+            paintOverlays(_dirty_rects[r], 0);
         }
 
-        clearAllDirty(_root);
+        _nodes.clearAllDirty();
 
         // Push each dirty rect to the e-ink display
         for (uint8_t r = 0; r < _dirty_count; r++) {
-            pushDirtyRect(_dirty_rects[r]);
+            if (underOverlay(_dirty_rects[r])) continue;   // panel shows the overlay there
+            pushDirtyRect(_dirty_rects[r], modes[r]);
         }
+        _dirty_count = 0;
 
         // Periodic full refresh to clear ghosting
         _partial_count++;
@@ -171,72 +809,186 @@ private:
         }
     }
 
-    void collectDirtyRects(Widget* w) {
-        if (!w || !w->isVisible()) return;
-        if (w->isDirty() && !w->isLayout()) {
-            // Only collect leaf widget rects
-            if (_dirty_count < MAX_DIRTY_RECTS) {
-                _dirty_rects[_dirty_count++] = w->bounds();
-            }
-        }
-        if (w->isLayout()) {
-            Layout* lay = static_cast<Layout*>(w);
-            for (uint8_t i = 0; i < lay->childCount(); i++) {
-                collectDirtyRects(lay->child(i));
-            }
+    // Leaf widget rects, plus whatever a layout asks for itself (most ask
+    // for nothing). Once the list is full, further rects are united into the
+    // last slot (and counted as dropped).
+    void collectDirtyRects() {
+        const uint8_t want = NODE_DIRTY | NODE_VISIBLE;
+        Rect tmp[MAX_DIRTY_RECTS];
+        for (uint16_t i = 0; i < _nodes.size(); i++) {
+            if ((_nodes.flags[i] & want) != want) continue;
+            Widget* w = _nodes.widget[i];
+            uint8_t n = w->dirtyRects(tmp, MAX_DIRTY_RECTS);
+            bool counts = n > 0 || !(_nodes.flags[i] & NODE_LAYOUT);
+            _nodes.hint[i] = counts ? w->updateHint() : UpdateHint::NONE;
+            for (uint8_t k = 0; k < n; k++) addDirtyRect(tmp[k]);
         }
     }
 
-    void redrawRegion(Widget* w, const Rect& region) {
-        if (!w || !w->isVisible()) return;
-        if (!w->bounds().intersects(region)) return;
+    // Let dirty layouts read the framebuffer before it is redrawn
+    void beforePaint() {
+        const uint8_t want = NODE_DIRTY | NODE_VISIBLE | NODE_LAYOUT;
+        for (uint16_t i = 0; i < _nodes.size(); i++) {
+            if ((_nodes.flags[i] & want) != want) continue;
+            static_cast<Layout*>(_nodes.widget[i])->beforePaint(*_gfx, overOverlay(_nodes.bounds[i]));
+        }
+    }
 
-        if (w->isLayout()) {
-            Layout* lay = static_cast<Layout*>(w);
-            if (lay->background() != Colors::WHITE) {
-                const Rect& b = lay->bounds();
-                _gfx->fillRect(b.x, b.y, b.w, b.h, lay->background());
-            }
-            for (uint8_t i = 0; i < lay->childCount(); i++) {
-                redrawRegion(lay->child(i), region);
-            }
+    void addDirtyRect(const Rect& r) {
+        if (r.isEmpty()) return;
+        if (_dirty_count < MAX_DIRTY_RECTS) {
+            _dirty_rects[_dirty_count++] = r;
         } else {
-            w->draw(*_gfx);
+            Rect& last = _dirty_rects[MAX_DIRTY_RECTS - 1];
+            last = last.unite(r);
+            _stats.dropped_rects++;
         }
     }
 
-    void clearAllDirty(Widget* w) {
-        if (!w) return;
-        w->clearDirty();
-        if (w->isLayout()) {
-            Layout* lay = static_cast<Layout*>(w);
-            for (uint8_t i = 0; i < lay->childCount(); i++) {
-                clearAllDirty(lay->child(i));
-            }
+    // --- Refresh budget ---
+
+    // Hold back non-urgent changes while the budget is short. They stay
+    // dirty, and idle() sleeps until the bucket can pay for them.
+    bool deferForBudget() {
+        if (!_budget.enabled() || _touch_frame || _dirty_count) return false;
+        uint32_t now = millis();
+        _budget.refill(now);
+        if (urgentDirty()) return false;
+        uint32_t cost = estimateDirtyCost();
+        if (_budget.canSpend(cost)) return false;
+        if (!_deferring) {
+            _stats.deferred_frames++;
+            PUI_LOG("budget: deferring %lu units for %lu ms", (unsigned long)cost,
+                    (unsigned long)_budget.msUntil(cost));
+        }
+        // One wake deadline per wait, re-armed once it has passed
+        if (!_deferring || (int32_t)(now - _defer_until) >= 0) {
+            _defer_until = now + _budget.msUntil(cost);
+            requestWakeAt(_defer_until);
+        }
+        _deferring = true;
+        return true;
+    }
+
+    bool budgetHolding() const { return _deferring && !urgentDirty(); }
+
+    bool urgentDirty() const {
+        const uint8_t want = NODE_DIRTY | NODE_VISIBLE;
+        for (uint16_t i = 0; i < _nodes.size(); i++) {
+            if ((_nodes.flags[i] & (want | NODE_LAYOUT)) != want) continue;
+            if (_nodes.widget[i]->priority() == Priority::URGENT) return true;
         }
+        return false;
     }
 
-    void markAllDirty(Widget* w) {
-        if (!w) return;
-        w->markDirty();
-        if (w->isLayout()) {
-            Layout* lay = static_cast<Layout*>(w);
-            for (uint8_t i = 0; i < lay->childCount(); i++) {
-                markAllDirty(lay->child(i));
+    // Upper bound from dirty leaf bounds (dirtyRects() may consume state,
+    // so it is not called before the frame is committed)
+    uint32_t estimateDirtyCost() const {
+        uint32_t cost = 0;
+        const uint8_t want = NODE_DIRTY | NODE_VISIBLE;
+        for (uint16_t i = 0; i < _nodes.size(); i++) {
+            if ((_nodes.flags[i] & (want | NODE_LAYOUT)) != want) continue;
+            cost += _energy.cost(_nodes.bounds[i],
+                                 epdSlot(modeForHint(_nodes.widget[i]->updateHint())));
+        }
+        return cost;
+    }
+
+    // Merge all rects into one push when that costs less than pushing them
+    // separately (per-push overhead vs. the extra area).
+    void coalesceForCost(epd_mode_t* modes) {
+        if (_dirty_count < 2) return;
+        uint32_t separate = 0;
+        Rect all = _dirty_rects[0];
+        uint8_t worst = epdSlot(modes[0]);
+        for (uint8_t r = 0; r < _dirty_count; r++) {
+            separate += _energy.cost(_dirty_rects[r], epdSlot(modes[r]));
+            all = all.unite(_dirty_rects[r]);
+            worst = min(worst, epdSlot(modes[r]));   // lower slot = slower mode
+        }
+        if (_energy.cost(all, worst) >= separate) return;
+        _stats.merged_rects += _dirty_count - 1;
+        _dirty_rects[0] = all;
+        modes[0] = selectEpdMode(all);
+        _dirty_count = 1;
+    }
+
+    // Attribute a pushed rect to the dirty leaves inside it
+    void chargePush(const Rect& rect, epd_mode_t mode) {
+#ifdef PAPERUI_WIDGET_STATS
+        uint8_t slot = epdSlot(mode);
+        const uint8_t want = NODE_DIRTY | NODE_VISIBLE;
+        for (uint16_t i = 0; i < _nodes.size(); i++) {
+            if ((_nodes.flags[i] & (want | NODE_LAYOUT)) != want) continue;
+            Rect part = _nodes.bounds[i].intersect(rect);
+            if (part.isEmpty()) continue;
+            WidgetStats& ws = _nodes.widget[i]->stats();
+            ws.pushes++;
+            ws.pixels[slot] += part.area();
+        }
+#else
+        (void)rect;
+        (void)mode;
+#endif
+    }
+
+    void redrawRegion(const Rect& region) {
+        uint16_t n = _nodes.size();
+        for (uint16_t i = 0; i < n;) {
+            if (!(_nodes.flags[i] & NODE_VISIBLE) ||
+                !_nodes.bounds[i].intersects(region)) {
+                i = _nodes.end[i];  // skip whole subtree
+                continue;
             }
+            Widget* w = _nodes.widget[i];
+            if (_nodes.flags[i] & NODE_LAYOUT) {
+                if (static_cast<Layout*>(w)->paintCached(*_gfx, region)) {
+                    i = _nodes.end[i];
+                    continue;
+                }
+                if (_nodes.flags[i] & NODE_BG) {
+                    const Rect& b = _nodes.bounds[i];
+                    _gfx->fillRect(b.x, b.y, b.w, b.h,
+                                   static_cast<Layout*>(w)->background());
+                }
+            } else {
+                PUI_TRACE_SCOPE(DRAW, i, w->id, _nodes.bounds[i]);
+#ifdef PAPERUI_WIDGET_STATS
+                uint32_t t0 = micros();
+#endif
+                if (region.unite(_nodes.bounds[i]) == region) {
+                    w->draw(*_gfx);  // fully covered
+                } else {
+                    w->drawRegion(*_gfx, region);
+                }
+#ifdef PAPERUI_WIDGET_STATS
+                WidgetStats& ws = w->stats();
+                ws.draws++;
+                ws.draw_us += micros() - t0;
+#endif
+            }
+            i++;
         }
     }
 
-    // Push a dirty rect to the e-ink display with appropriate update mode
-    void pushDirtyRect(const Rect& dr) {
-        auto mode = selectEpdMode(dr);
+    // Push a dirty rect to the e-ink display with the chosen update mode
+    void pushDirtyRect(const Rect& dr, epd_mode_t mode) {
+        PUI_TRACE_SCOPE(PUSH, NO_NODE, 0, dr, epdSlot(mode));
+        uint32_t cost = _energy.cost(dr, epdSlot(mode));
+        _stats.energy += cost;
+        if (_budget.enabled()) _budget.spend(cost);
+        _stats.pixels[epdSlot(mode)] += dr.area();
+        if (dr.area() < (uint32_t)SCREEN_W * SCREEN_H) _stats.partials++;
         _gfx->setEpdMode(mode);
         _gfx->display(dr.x, dr.y, dr.w, dr.h);
     }
 
     epd_mode_t selectEpdMode(const Rect& region) {
-        UpdateHint worst = worstHintInRegion(_root, region);
-        switch (worst) {
+        return modeForHint(worstHintInRegion(region));
+    }
+
+    static epd_mode_t modeForHint(UpdateHint hint) {
+        switch (hint) {
             case UpdateHint::QUALITY: return epd_mode_t::epd_quality;
             case UpdateHint::TEXT:    return epd_mode_t::epd_text;
             case UpdateHint::FAST:    return epd_mode_t::epd_fast;
@@ -245,43 +997,66 @@ private:
         }
     }
 
-    UpdateHint worstHintInRegion(Widget* w, const Rect& region) {
-        if (!w || !w->isVisible() || !w->bounds().intersects(region))
-            return UpdateHint::NONE;
-
+    // Layouts that pushed nothing of their own carry NONE
+    UpdateHint worstHintInRegion(const Rect& region) {
         UpdateHint result = UpdateHint::NONE;
-        if (w->isDirty()) result = w->updateHint();
-
-        if (w->isLayout()) {
-            Layout* lay = static_cast<Layout*>(w);
-            for (uint8_t i = 0; i < lay->childCount(); i++) {
-                UpdateHint ch = worstHintInRegion(lay->child(i), region);
-                if ((uint8_t)ch > (uint8_t)result) result = ch;
-            }
+        const uint8_t want = NODE_DIRTY | NODE_VISIBLE;
+        for (uint16_t i = 0; i < _nodes.size(); i++) {
+            if ((_nodes.flags[i] & want) != want) continue;
+            if (!_nodes.bounds[i].intersects(region)) continue;
+            if ((uint8_t)_nodes.hint[i] > (uint8_t)result) result = _nodes.hint[i];
         }
         return result;
     }
 
-    void syncAll(Widget* w) {
-        if (!w) return;
-        w->sync();
-        if (w->isLayout()) {
-            Layout* lay = static_cast<Layout*>(w);
-            for (uint8_t i = 0; i < lay->childCount(); i++)
-                syncAll(lay->child(i));
+    void syncBindings() {
+        syncAll();
+        _last_synced_gen = StateBase::global_gen();
+    }
+
+    void syncAll() {
+        PUI_TRACE_SCOPE(SYNC);
+        for (uint16_t i = 0; i < _nodes.size(); i++) {
+            _nodes.widget[i]->sync();
+        }
+        for (uint8_t k = 0; k < _overlay_count; k++) {
+            Overlay::syncTree(_overlays[_overlay_order[k]].root);
         }
     }
 
     // --- Members ---
     M5GFX* _gfx = nullptr;
-    Layout* _root = nullptr;
+    Widget* _root = nullptr;
     uint32_t _last_synced_gen = 0;
+    NodeTable _nodes;
+    uint32_t _tree_gen = 0;
+    uint16_t _overflow_warned = 0;   // needed() last warned about
 
     // Touch state
-    bool _touch_active = false;
-    int16_t _last_x = 0;
-    int16_t _last_y = 0;
-    unsigned long _debounce_until = 0;
+    TouchGrid _touch_grid;
+    UiSnapshot _prev = UiSnapshot();   // old tree during a rebuild
+    Overlay _overlays[PAPERUI_MAX_OVERLAYS];
+    uint8_t _overlay_order[PAPERUI_MAX_OVERLAYS];   // slot indices, bottom to top
+    uint8_t _overlay_count = 0;
+    bool _overlay_touch = false;   // the last touch went to the overlay layer
+    IdIndex _ids;
+    bool _ids_stale = true;
+    GestureRecognizer _gestures;
+    TouchSampler _sampler;
+    Widget* _captured = nullptr;
+    Widget* _gesture_target = nullptr;
+    OnGestureCallback _on_gesture = nullptr;
+    void* _gesture_data = nullptr;
+
+    IdleConfig _idle;
+    ScreenStats _stats;
+
+    // Refresh budget
+    EnergyModel _energy;
+    EnergyBudget _budget;
+    bool _deferring = false;
+    uint32_t _defer_until = 0;
+    bool _touch_frame = false;
 
     // Dirty tracking
     Rect _dirty_rects[MAX_DIRTY_RECTS];
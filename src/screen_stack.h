@@ -0,0 +1,101 @@
+#pragma once
+
+#include "screen.h"
+
+#ifndef PAPERUI_STACK_DEPTH
+#define PAPERUI_STACK_DEPTH 4
+#endif
+
+namespace PaperUI {
+
+// Navigation stack of retained pages. Every page keeps its own laid-out
+// tree, so going back never re-measures; with caching on, the page's last
+// image (without any overlay shown on it) is kept in PSRAM and going back
+// is one full push of those pixels plus whatever changed on the page since.
+//
+// Pages stay alive while on the stack: build them once (sized pools or
+// static trees) and don't ui::reset() underneath them.
+class ScreenStack {
+public:
+    static constexpr uint8_t DEPTH = PAPERUI_STACK_DEPTH;
+
+    explicit ScreenStack(Screen& screen) : _screen(screen) {}
+
+    // Keep a PSRAM image of every page that is covered by push()
+    ScreenStack& cachePages(bool on) {
+        _cache = on;
+        if (!on) {
+            for (uint8_t i = 0; i < _depth; i++) _pages[i].cache.release();
+        }
+        return *this;
+    }
+
+    // Replace the whole stack with `page` as its only entry
+    void home(Widget& page) {
+        for (uint8_t i = 0; i < DEPTH; i++) _pages[i].clear();
+        _depth = 0;
+        push(page);
+    }
+
+    // Show `page` on top, laid out afresh: a page that was popped may have
+    // been rebuilt in the same pool slots since
+    bool push(Widget& page) {
+        if (_depth >= DEPTH) return false;
+        if (_depth > 0 && _cache) _screen.capturePage(_pages[_depth - 1].cache);
+        Page& p = _pages[_depth++];
+        p.root = &page;
+        p.cache.invalidate();
+        _screen.root(page);
+        p.laid_out = true;
+        return true;
+    }
+
+    // Back to the page below; false at the bottom
+    bool pop() {
+        if (_depth <= 1) return false;
+        _pages[--_depth].clear();
+        Page& p = _pages[_depth - 1];
+        if (p.laid_out) {
+            _screen.resume(*p.root, p.cache.valid() ? &p.cache : nullptr);
+        } else {
+            _screen.root(*p.root);
+            p.laid_out = true;
+        }
+        p.cache.invalidate();   // stale once the page is live again
+        return true;
+    }
+
+    // The page's tree changed shape while it was covered: lay it out
+    // again when it is shown
+    void relayout(Widget& page) {
+        for (uint8_t i = 0; i < DEPTH; i++) {
+            if (_pages[i].root == &page) {
+                _pages[i].laid_out = false;
+                _pages[i].cache.invalidate();
+            }
+        }
+    }
+
+    Widget* top() const { return _depth ? _pages[_depth - 1].root : nullptr; }
+    uint8_t depth() const { return _depth; }
+
+private:
+    struct Page {
+        Widget* root = nullptr;
+        bool laid_out = false;
+        PixelCache cache;
+
+        void clear() {
+            root = nullptr;
+            laid_out = false;
+            cache.release();
+        }
+    };
+
+    Screen& _screen;
+    Page _pages[DEPTH];
+    uint8_t _depth = 0;
+    bool _cache = false;
+};
+
+} // namespace PaperUI
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "state.h"
+
+namespace PaperUI {
+
+// Min/max/average of a run of samples; count 0 means no data
+struct SeriesSummary {
+    float min = 0;
+    float max = 0;
+    float sum = 0;
+    uint32_t count = 0;
+
+    float avg() const { return count ? sum / count : 0.0f; }
+
+    void add(float v) {
+        if (count == 0 || v < min) min = v;
+        if (count == 0 || v > max) max = v;
+        sum += v;
+        count++;
+    }
+
+    void add(const SeriesSummary& o) {
+        if (o.count == 0) return;
+        if (count == 0 || o.min < min) min = o.min;
+        if (count == 0 || o.max > max) max = o.max;
+        sum += o.sum;
+        count += o.count;
+    }
+};
+
+// Long sample history in fixed memory. The newest samples are kept raw (a
+// RingState, which charts can bind directly); on top of them, level k
+// (1..LEVELS) keeps the last N summaries of FANOUT^k samples each, updated
+// as samples arrive. Every level spans FANOUT times as far back as the one
+// below it: N * FANOUT^LEVELS samples in LEVELS * N * 16 bytes plus RAW
+// floats. The defaults (N 128, LEVELS 5, FANOUT 4) cover about 36 hours of
+// 1 Hz data in 10 KB plus the raw ring; a sixth level makes that 6 days.
+//
+// summarize() answers "min/max/avg of each of `n` columns over samples
+// [from, to)" from the coarsest level whose buckets are no wider than a
+// column, touching fewer than FANOUT buckets per column: O(n), however
+// long the span. Storage comes from TimeSeries<RAW, N, LEVELS, FANOUT>.
+class TimeSeriesBase : public StateBase {
+public:
+    TimeSeriesBase(const TimeSeriesBase&) = delete;
+    TimeSeriesBase& operator=(const TimeSeriesBase&) = delete;
+
+    void push(float v) {
+        uint32_t seq = _raw.appended();
+        uint32_t size = 1;
+        for (uint8_t k = 0; k < _levels; k++) {
+            size *= _fanout;
+            SeriesSummary& b = _buckets[(uint32_t)k * _n + (seq / size) % _n];
+            if (seq % size == 0) b = SeriesSummary();
+            b.add(v);
+        }
+        _raw.push(v);   // bumps the generation last, with the levels in place
+    }
+
+    void clear() {
+        for (uint32_t i = 0; i < (uint32_t)_levels * _n; i++) _buckets[i] = SeriesSummary();
+        _raw.clear();
+    }
+
+    RingStateBase& raw() { return _raw; }
+    const RingStateBase& raw() const { return _raw; }
+    uint32_t appended() const { return _raw.appended(); }
+    uint32_t generation() const { return _raw.generation(); }
+    uint8_t levels() const { return _levels; }
+
+    // Samples per bucket at `level` (0 = raw)
+    uint32_t bucketSize(uint8_t level) const {
+        uint32_t b = 1;
+        for (uint8_t k = 0; k < level; k++) b *= _fanout;
+        return b;
+    }
+
+    // First sample `level` still covers; earlier ones are gone there
+    uint32_t heldFrom(uint8_t level) const {
+        if (level == 0) return _raw.oldest();
+        uint32_t end = _raw.appended();
+        if (end == 0) return 0;
+        uint32_t b = bucketSize(level);
+        uint32_t open = (end - 1) / b;
+        return open + 1 > _n ? (open + 1 - _n) * b : 0;
+    }
+
+    // First sample any level still covers
+    uint32_t oldest() const { return heldFrom(_levels); }
+
+    // Summaries of samples [from, to) in `n` equal columns. Columns with no
+    // data left (older than the history) get count 0. Returns the level
+    // used.
+    uint8_t summarize(uint32_t from, uint32_t to, SeriesSummary* out, uint16_t n) const {
+        for (uint16_t p = 0; p < n; p++) out[p] = SeriesSummary();
+        if (n == 0 || to <= from) return 0;
+        uint8_t level = pickLevel(from, (to - from) / n);
+        uint32_t b = bucketSize(level);
+        uint32_t end = _raw.appended();
+        uint32_t first = heldFrom(level);
+        for (uint16_t p = 0; p < n; p++) {
+            uint32_t a = from + (uint32_t)((uint64_t)(to - from) * p / n);
+            uint32_t z = from + (uint32_t)((uint64_t)(to - from) * (p + 1) / n);
+            if (z > end) z = end;
+            if (level == 0) {
+                for (uint32_t s = a < first ? first : a; s < z; s++) out[p].add(_raw.at(s));
+                continue;
+            }
+            if (z - a < b) {
+                // Column narrower than a bucket (zoomed past the history
+                // still kept that fine): the bucket holding it
+                uint32_t j = a / b;
+                if (j * b >= first && j * b < end) out[p].add(bucket(level, j));
+                continue;
+            }
+            // Buckets starting inside the column
+            for (uint32_t j = (a + b - 1) / b; j * b < z; j++) {
+                if (j * b >= first) out[p].add(bucket(level, j));
+            }
+        }
+        return level;
+    }
+
+protected:
+    TimeSeriesBase(RingStateBase& raw, SeriesSummary* buckets, uint16_t n,
+                   uint8_t levels, uint8_t fanout)
+        : _raw(raw), _buckets(buckets), _n(n), _levels(levels), _fanout(fanout) {}
+
+private:
+    const SeriesSummary& bucket(uint8_t level, uint32_t j) const {
+        return _buckets[(uint32_t)(level - 1) * _n + j % _n];
+    }
+
+    // Coarsest level with buckets no wider than a column that still covers
+    // `from`; else the finest one that covers it; else the coarsest
+    uint8_t pickLevel(uint32_t from, uint32_t per_column) const {
+        if (per_column == 0) per_column = 1;
+        for (int16_t k = _levels; k >= 0; k--) {
+            if (bucketSize((uint8_t)k) <= per_column && heldFrom((uint8_t)k) <= from) return (uint8_t)k;
+        }
+        for (uint8_t k = 0; k <= _levels; k++) {
+            if (heldFrom(k) <= from) return k;
+        }
+        return _levels;
+    }
+
+    RingStateBase& _raw;
+    SeriesSummary* _buckets;   // _levels rows of _n
+    uint16_t _n;
+    uint8_t _levels;
+    uint8_t _fanout;
+};
+
+template <uint16_t RAW, uint16_t N = 128, uint8_t LEVELS = 5, uint8_t FANOUT = 4>
+class TimeSeries : public TimeSeriesBase {
+public:
+    TimeSeries() : TimeSeriesBase(_samples, _summaries, N, LEVELS, FANOUT) {}
+
+private:
+    RingState<RAW> _samples;
+    SeriesSummary _summaries[LEVELS * N];
+};
+
+} // namespace PaperUI
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "node_table.h"
+
+#ifndef PAPERUI_SNAPSHOT_NODES
+#define PAPERUI_SNAPSHOT_NODES PAPERUI_MAX_NODES
+#endif
+
+namespace PaperUI {
+
+// What the panel shows, compact enough for RTC memory: bounds, content
+// hash, id, parent and kind of every node, in node-table order (17 bytes
+// per node).
+//
+// Keep it trivially constructible: a constructor would run on every boot
+// and wipe an RTC_DATA_ATTR copy before restore() could read it.
+struct UiSnapshot {
+    static constexpr uint32_t MAGIC = 0x32495550UL;   // "PUI2"
+    static constexpr uint16_t CAPACITY = PAPERUI_SNAPSHOT_NODES;
+    static constexpr uint8_t KIND = NODE_VISIBLE | NODE_LAYOUT | NODE_BG | NODE_TOUCH;
+
+    struct Box { int16_t x, y, w, h; };
+
+    uint32_t magic;
+    uint16_t count;
+    uint16_t partial_count;   // keeps the ghosting refresh cadence across sleeps
+    Box bounds[CAPACITY];
+    uint32_t hash[CAPACITY];  // 0 = unknown, always redrawn
+    uint16_t id[CAPACITY];
+    uint16_t parent[CAPACITY];
+    uint8_t flags[CAPACITY];  // node flags masked by KIND
+
+    bool valid() const { return magic == MAGIC && count <= CAPACITY; }
+    void invalidate() { magic = 0; }
+
+    static Box box(const Rect& r) { Box b = {r.x, r.y, r.w, r.h}; return b; }
+    static Rect rect(const Box& b) { return Rect(b.x, b.y, b.w, b.h); }
+
+    // Per-node hash: widget content plus effective visibility
+    static uint32_t nodeHash(const NodeTable& nodes, uint16_t i) {
+        uint32_t h = nodes.widget[i]->contentHash();
+        if (h == 0) return 0;
+        return Hasher().add(h).add((uint8_t)(nodes.flags[i] & NODE_VISIBLE)).value();
+    }
+
+    // Record the table. Dirty nodes are not on the panel yet and get hash
+    // 0. Fails (invalid) if the table overflowed or does not fit.
+    bool capture(const NodeTable& nodes, uint16_t partials) {
+        invalidate();
+        if (nodes.overflowed() || nodes.size() > CAPACITY) return false;
+        for (uint16_t i = 0; i < nodes.size(); i++) {
+            bounds[i] = box(nodes.bounds[i]);
+            hash[i] = (nodes.flags[i] & NODE_DIRTY) ? 0 : nodeHash(nodes, i);
+            id[i] = nodes.widget[i]->id;
+            parent[i] = nodes.parent[i];
+            flags[i] = nodes.flags[i] & KIND;
+        }
+        count = nodes.size();
+        partial_count = partials;
+        magic = MAGIC;
+        return true;
+    }
+
+    // For each node in `nodes`, the snapshot node it continues, or NO_NODE.
+    // Nodes with an id pair up by id; the others by position, the k-th
+    // id-less child of a matched parent with the k-th id-less child of its
+    // match. Layouts only match layouts and leaves only leaves.
+    void match(const NodeTable& nodes, uint16_t* out) const {
+        uint16_t ord_old[CAPACITY];
+        uint16_t ord_new[NodeTable::CAPACITY];
+        uint8_t used[(CAPACITY + 7) / 8] = {};
+        siblingOrder(parent, id, count, ord_old);
+
+        uint16_t cnt[NodeTable::CAPACITY] = {};
+        for (uint16_t i = 0; i < nodes.size(); i++) {
+            uint16_t p = nodes.parent[i];
+            ord_new[i] = (p == NO_NODE || nodes.widget[i]->id) ? 0 : cnt[p]++;
+        }
+
+        for (uint16_t i = 0; i < nodes.size(); i++) {
+            out[i] = NO_NODE;
+            uint16_t wid = nodes.widget[i]->id;
+            uint16_t p = nodes.parent[i];
+            uint16_t pm = p == NO_NODE ? NO_NODE : out[p];
+            if (!wid && p != NO_NODE && pm == NO_NODE) continue;
+            for (uint16_t j = 0; j < count; j++) {
+                if (used[j >> 3] & (1 << (j & 7))) continue;
+                if ((flags[j] & NODE_LAYOUT) != (nodes.flags[i] & NODE_LAYOUT)) continue;
+                bool hit = wid ? id[j] == wid
+                               : id[j] == 0 && parent[j] == pm &&
+                                 (pm == NO_NODE || ord_old[j] == ord_new[i]);
+                if (!hit) continue;
+                out[i] = j;
+                used[j >> 3] |= 1 << (j & 7);
+                break;
+            }
+        }
+    }
+
+private:
+    static void siblingOrder(const uint16_t* par, const uint16_t* ids, uint16_t n, uint16_t* ord) {
+        uint16_t cnt[CAPACITY] = {};
+        for (uint16_t j = 0; j < n; j++) {
+            uint16_t p = par[j];
+            ord[j] = (p == NO_NODE || p >= n || ids[j]) ? 0 : cnt[p]++;
+        }
+    }
+};
+
+} // namespace PaperUI
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdint.h>
+#include "intern.h"
 
 namespace PaperUI {
 
@@ -40,7 +41,163 @@ public:
 
 private:
     T _value = {};
-    uint32_t _generation = 0;
+    uint32_t _generation = 1;   // bindings start at 0, so their first sync applies
+};
+
+// Strings are compared by contents, not by pointer: set() with a reused
+// buffer holding new text is a change, a different buffer with the same
+// text is not. The value is copied into the StringArena, so get() stays
+// valid after the caller's buffer goes away. If the arena is full, the
+// caller's pointer is kept as is (and must outlive the state). The old
+// copy is released only after the new value is in place, so set() may be
+// given a pointer into get().
+template <>
+class State<const char*> : public StateBase {
+public:
+    State() = default;
+    explicit State(const char* initial) { assign(initial, TextKey(initial)); }
+    ~State() { StringArena::release(_block); }
+
+    State(const State&) = delete;
+    State& operator=(const State&) = delete;
+
+    const char* const& get() const { return _value; }
+
+    bool set(const char* new_val) {
+        if (!new_val) new_val = "";
+        TextKey k(new_val);
+        if (k == _key) return false;
+        assign(new_val, k);
+        _generation++;
+        global_gen()++;
+        return true;
+    }
+
+    uint32_t generation() const { return _generation; }
+    const TextKey& key() const { return _key; }
+
+    operator const char* const&() const { return _value; }
+
+private:
+    // Without a new copy, a pointer into the old one keeps it alive
+    void assign(const char* s, const TextKey& k) {
+        if (!s) s = "";
+        const char* copy = StringArena::intern(s, k);
+        const char* old = _block;
+        bool inside = !copy && old && s >= old && s <= old + _key.len;
+        _value = copy ? copy : s;
+        _key = k;
+        if (inside) return;
+        _block = copy;
+        StringArena::release(old);
+    }
+
+    const char* _value = "";
+    const char* _block = nullptr;   // arena copy holding our reference
+    TextKey _key = TextKey("");
+    uint32_t _generation = 1;
+};
+
+// Fixed-capacity history of float samples: push() appends, dropping the
+// oldest when full. Samples are addressed by sequence number (0 = first
+// ever pushed), so a binding that remembers appended() knows exactly which
+// samples are new since it last looked. Storage comes from RingState<N>.
+class RingStateBase : public StateBase {
+public:
+    RingStateBase(const RingStateBase&) = delete;
+    RingStateBase& operator=(const RingStateBase&) = delete;
+
+    void push(float v) {
+        _data[_head] = v;
+        _head = (uint16_t)(_head + 1 == _capacity ? 0 : _head + 1);
+        if (_size < _capacity) _size++;
+        _appended++;
+        _generation++;
+        global_gen()++;
+    }
+
+    void clear() {
+        _head = 0;
+        _size = 0;
+        _appended = 0;
+        _generation++;
+        global_gen()++;
+    }
+
+    uint16_t size() const { return _size; }
+    uint16_t capacity() const { return _capacity; }
+    uint32_t appended() const { return _appended; }        // sequence number of the next push
+    uint32_t oldest() const { return _appended - _size; }  // first sequence number still held
+    bool holds(uint32_t seq) const { return seq >= oldest() && seq < _appended; }
+
+    // Sample `seq`; holds(seq) must be true
+    float at(uint32_t seq) const {
+        uint32_t back = _appended - seq;   // 1 = newest
+        int32_t i = (int32_t)_head - (int32_t)back;
+        return _data[i < 0 ? i + _capacity : i];
+    }
+    float latest() const { return _size ? at(_appended - 1) : 0.0f; }
+
+    uint32_t generation() const { return _generation; }
+
+protected:
+    RingStateBase(float* data, uint16_t capacity) : _data(data), _capacity(capacity) {}
+
+private:
+    float* _data;
+    uint16_t _capacity;
+    uint16_t _head = 0;
+    uint16_t _size = 0;
+    uint32_t _appended = 0;
+    uint32_t _generation = 1;
+};
+
+template <uint16_t N>
+class RingState : public RingStateBase {
+public:
+    RingState() : RingStateBase(_samples, N) {}
+
+private:
+    float _samples[N];
+};
+
+// Per-binding filter for noisy numeric sources. A value is accepted only
+// if it moved past the deadband (absolute, or relative to the last accepted
+// value) and at least `min_interval_ms` passed since the last accepted one.
+// Values held back by the interval are not dropped: the binding retries
+// at `retryAt()` with whatever the state holds then (latest value wins).
+struct BindingFilter {
+    float abs_deadband = 0;
+    float rel_deadband = 0;        // fraction, e.g. 0.01 = 1%
+    uint16_t min_interval_ms = 0;
+
+    bool active() const { return abs_deadband > 0 || rel_deadband > 0 || min_interval_ms > 0; }
+
+    enum Result : uint8_t { ACCEPT, REJECT, LATER };
+
+    Result check(float v, uint32_t now) const {
+        if (!_has_last) return ACCEPT;
+        float d = v > _last ? v - _last : _last - v;
+        float mag = _last < 0 ? -_last : _last;
+        if (d <= abs_deadband || (rel_deadband > 0 && d <= rel_deadband * mag)) return REJECT;
+        if (min_interval_ms && (uint32_t)(now - _last_ms) < min_interval_ms) return LATER;
+        return ACCEPT;
+    }
+
+    void accepted(float v, uint32_t now) {
+        _last = v;
+        _last_ms = now;
+        _has_last = true;
+    }
+
+    uint32_t retryAt() const { return _last_ms + min_interval_ms; }
+
+    void reset() { _has_last = false; }
+
+private:
+    float _last = 0;
+    uint32_t _last_ms = 0;
+    bool _has_last = false;
 };
 
 } // namespace PaperUI
@@ -0,0 +1,504 @@
+#pragma once
+
+#include "widget.h"
+#include "layout.h"
+#include <stddef.h>
+#include <tuple>
+#include <type_traits>
+
+namespace PaperUI {
+
+// Compile-time UI trees.
+//
+// `sui::col()` / `sui::row()` produce a tree whose full shape is part of its
+// type: children are held by value in a std::tuple, every traversal is
+// expanded and inlined at compile time, and widget methods are called
+// non-virtually. Subtrees built only from `sui::fixed<W, H>()` and
+// `sui::space<W, H>()` nodes have their size and child offsets computed by
+// the compiler. The tree lives wherever you declare it -- no pool slots.
+//
+//   State<float> temp(0), bat(0);
+//   static auto status = sui::root(sui::row<8, Align::CENTER>(
+//       sui::fixed<100, 20>(sui::leaf(BatteryWidget().bind(bat))),
+//       sui::space<16, 0>(),
+//       sui::leaf(ValueWidget().format("%.1f C").bind(temp))
+//   ));
+//   screen.root(status);
+//
+// To the rest of the framework a StaticRoot is a single leaf widget that
+// reports (and redraws) only its dirty inner leaves. After changing a leaf
+// directly instead of through a State, call markDirty() on the root.
+namespace sui {
+
+namespace detail {
+
+template <size_t... I> struct Indices {};
+template <size_t N, size_t... I>
+struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+template <size_t... I>
+struct MakeIndices<0, I...> { typedef Indices<I...> type; };
+
+using expander = int[];
+
+template <bool... B> struct All;
+template <> struct All<> : std::true_type {};
+template <bool B0, bool... B>
+struct All<B0, B...> : std::integral_constant<bool, B0 && All<B...>::value> {};
+
+template <bool... B> struct Any;
+template <> struct Any<> : std::false_type {};
+template <bool B0, bool... B>
+struct Any<B0, B...> : std::integral_constant<bool, B0 || Any<B...>::value> {};
+
+template <int16_t... V> struct Sum;
+template <> struct Sum<> { static constexpr int16_t value = 0; };
+template <int16_t V0, int16_t... V>
+struct Sum<V0, V...> { static constexpr int16_t value = V0 + Sum<V...>::value; };
+
+template <int16_t... V> struct Max;
+template <> struct Max<> { static constexpr int16_t value = 0; };
+template <int16_t V0, int16_t... V>
+struct Max<V0, V...> {
+    static constexpr int16_t value = V0 > Max<V...>::value ? V0 : Max<V...>::value;
+};
+
+// Main-axis offset of element I: the extents before it plus spacing.
+template <size_t I, int16_t SP, int16_t... E> struct Offset;
+template <int16_t SP, int16_t E0, int16_t... E>
+struct Offset<0, SP, E0, E...> { static constexpr int16_t value = 0; };
+template <size_t I, int16_t SP, int16_t E0, int16_t... E>
+struct Offset<I, SP, E0, E...> {
+    static constexpr int16_t value = E0 + SP + Offset<I - 1, SP, E...>::value;
+};
+
+inline int16_t clamp16(int16_t v, int16_t lo, int16_t hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+inline UpdateHint worse(UpdateHint a, UpdateHint b) {
+    return (uint8_t)a >= (uint8_t)b ? a : b;
+}
+
+} // namespace detail
+
+// Node protocol (all non-virtual):
+//   FIXED, FW, FH     size known at compile time (FW/FH are 0 otherwise)
+//   NEEDS_MEASURE     measure() has side effects the subtree depends on
+//   measure, place, bounds, draw, drawRegion, sync, onTouch,
+//   isDirty, clearDirty, dirtyRects, dirtyHint, contentHash (0 = unknown)
+
+// Wraps one widget held by value. Layouts are not allowed -- use col/row.
+template <typename T>
+class Leaf {
+    static_assert(std::is_base_of<Widget, T>::value, "Leaf needs a Widget");
+    static_assert(!std::is_base_of<Layout, T>::value,
+                  "use sui::col()/sui::row() instead of dynamic layouts");
+public:
+    static constexpr bool FIXED = false;
+    static constexpr bool NEEDS_MEASURE = false;
+    static constexpr int16_t FW = 0;
+    static constexpr int16_t FH = 0;
+
+    explicit Leaf(const T& w) : _w(w) {}
+
+    T& widget() { return _w; }
+    const Rect& bounds() const { return _w.bounds(); }
+
+    Size measure(const Constraints& c) { return _w.T::measure(c); }
+    void place(int16_t x, int16_t y, int16_t w, int16_t h) { _w.place(x, y, w, h); }
+
+    void draw(M5GFX& gfx) { if (_w.isVisible()) _w.T::draw(gfx); }
+    void drawRegion(M5GFX& gfx, const Rect& r) {
+        if (_w.isVisible() && _w.bounds().intersects(r)) _w.T::draw(gfx);
+    }
+
+    void sync() { _w.T::sync(); }
+    bool onTouch(const TouchEvent& e) { return _w.isVisible() && _w.T::onTouch(e); }
+
+    bool isDirty() const { return _w.isDirty(); }
+    void clearDirty() { _w.clearDirty(); }
+    uint8_t dirtyRects(Rect* out, uint8_t max) {
+        if (!_w.isDirty() || !_w.isVisible() || max == 0) return 0;
+        out[0] = _w.bounds();
+        return 1;
+    }
+    UpdateHint dirtyHint() const {
+        return (_w.isDirty() && _w.isVisible()) ? _w.T::updateHint() : UpdateHint::NONE;
+    }
+    uint32_t contentHash() const {
+        return _w.isVisible() ? _w.T::contentHash() : Hasher().value();
+    }
+
+private:
+    T _w;
+};
+
+// Empty node of a fixed size.
+template <int16_t W, int16_t H>
+class Space {
+public:
+    static constexpr bool FIXED = true;
+    static constexpr bool NEEDS_MEASURE = false;
+    static constexpr int16_t FW = W;
+    static constexpr int16_t FH = H;
+
+    const Rect& bounds() const { return _bounds; }
+    Size measure(const Constraints&) { return Size(W, H); }
+    void place(int16_t x, int16_t y, int16_t w, int16_t h) { _bounds = Rect(x, y, w, h); }
+    void draw(M5GFX&) {}
+    void drawRegion(M5GFX&, const Rect&) {}
+    void sync() {}
+    bool onTouch(const TouchEvent&) { return false; }
+    bool isDirty() const { return false; }
+    void clearDirty() {}
+    uint8_t dirtyRects(Rect*, uint8_t) { return 0; }
+    UpdateHint dirtyHint() const { return UpdateHint::NONE; }
+    uint32_t contentHash() const { return Hasher().value(); }
+
+private:
+    Rect _bounds;
+};
+
+// Gives a node a compile-time size so enclosing containers can lay it out
+// without measuring.
+template <int16_t W, int16_t H, typename N>
+class Fixed {
+public:
+    static constexpr bool FIXED = true;
+    static constexpr bool NEEDS_MEASURE = N::NEEDS_MEASURE;
+    static constexpr int16_t FW = W;
+    static constexpr int16_t FH = H;
+
+    explicit Fixed(const N& n) : _n(n) {}
+
+    N& inner() { return _n; }
+    const Rect& bounds() const { return _n.bounds(); }
+
+    Size measure(const Constraints&) {
+        if (NEEDS_MEASURE) _n.measure(Constraints(W, H, W, H));
+        return Size(W, H);
+    }
+    void place(int16_t x, int16_t y, int16_t w, int16_t h) { _n.place(x, y, w, h); }
+
+    void draw(M5GFX& gfx) { _n.draw(gfx); }
+    void drawRegion(M5GFX& gfx, const Rect& r) { _n.drawRegion(gfx, r); }
+    void sync() { _n.sync(); }
+    bool onTouch(const TouchEvent& e) { return _n.onTouch(e); }
+    bool isDirty() const { return _n.isDirty(); }
+    void clearDirty() { _n.clearDirty(); }
+    uint8_t dirtyRects(Rect* out, uint8_t max) { return _n.dirtyRects(out, max); }
+    UpdateHint dirtyHint() const { return _n.dirtyHint(); }
+    uint32_t contentHash() const { return _n.contentHash(); }
+
+private:
+    N _n;
+};
+
+// Column (VERTICAL) or row of statically typed children.
+template <bool VERTICAL, int16_t SP, Align A, typename... Cs>
+class Linear {
+public:
+    static constexpr size_t N = sizeof...(Cs);
+    static constexpr bool FIXED = detail::All<Cs::FIXED...>::value;
+    static constexpr bool NEEDS_MEASURE =
+        !FIXED || detail::Any<Cs::NEEDS_MEASURE...>::value;
+
+    static constexpr int16_t GAPS = N > 1 ? SP * (int16_t)(N - 1) : 0;
+    static constexpr int16_t FW = !FIXED ? 0
+        : VERTICAL ? detail::Max<Cs::FW...>::value
+                   : detail::Sum<Cs::FW...>::value + GAPS;
+    static constexpr int16_t FH = !FIXED ? 0
+        : VERTICAL ? detail::Sum<Cs::FH...>::value + GAPS
+                   : detail::Max<Cs::FH...>::value;
+
+    explicit Linear(const Cs&... cs) : _c(cs...) {}
+
+    template <size_t I>
+    typename std::tuple_element<I, std::tuple<Cs...>>::type& get() {
+        return std::get<I>(_c);
+    }
+
+    const Rect& bounds() const { return _bounds; }
+
+    Size measure(const Constraints& c) {
+        if (FIXED) {
+            // Children only need measuring if they hide runtime-sized nodes
+            if (NEEDS_MEASURE) measureFixed(Idx());
+            return Size(detail::clamp16(FW, c.min_w, c.max_w),
+                        detail::clamp16(FH, c.min_h, c.max_h));
+        }
+        int16_t main = 0, cross = 0;
+        measureEach(c, main, cross, Idx());
+        int16_t w = VERTICAL ? cross : main;
+        int16_t h = VERTICAL ? main : cross;
+        return Size(detail::clamp16(w, c.min_w, c.max_w),
+                    detail::clamp16(h, c.min_h, c.max_h));
+    }
+
+    void place(int16_t x, int16_t y, int16_t w, int16_t h) {
+        _bounds = Rect(x, y, w, h);
+        int16_t cursor = VERTICAL ? y : x;
+        placeEach(cursor, FixedTag(), Idx());
+    }
+
+    void draw(M5GFX& gfx) { drawEach(gfx, Idx()); }
+
+    void drawRegion(M5GFX& gfx, const Rect& r) {
+        if (!_bounds.intersects(r)) return;
+        drawRegionEach(gfx, r, Idx());
+    }
+
+    void sync() { syncEach(Idx()); }
+
+    // Topmost (last) child first, like Layout::onTouch
+    bool onTouch(const TouchEvent& e) { return touchEach(e, Idx()); }
+
+    bool isDirty() const { return dirtyEach(Idx()); }
+    void clearDirty() { clearEach(Idx()); }
+    uint8_t dirtyRects(Rect* out, uint8_t max) { return rectsEach(out, max, Idx()); }
+    UpdateHint dirtyHint() const { return hintEach(Idx()); }
+    uint32_t contentHash() const { return hashEach(Idx()); }
+
+private:
+    typedef typename detail::MakeIndices<N>::type Idx;
+    typedef std::integral_constant<bool, FIXED> FixedTag;
+    template <size_t I>
+    using Child = typename std::tuple_element<I, std::tuple<Cs...>>::type;
+
+    template <size_t... I>
+    void measureFixed(detail::Indices<I...>) {
+        (void)detail::expander{0, (std::get<I>(_c).measure(
+            Constraints(Cs::FW, Cs::FH, Cs::FW, Cs::FH)), 0)...};
+    }
+
+    template <size_t... I>
+    void measureEach(const Constraints& c, int16_t& main, int16_t& cross,
+                     detail::Indices<I...>) {
+        (void)detail::expander{0, (measureChild<I>(c, main, cross), 0)...};
+    }
+
+    template <size_t I>
+    void measureChild(const Constraints& c, int16_t& main, int16_t& cross) {
+        int16_t avail = (VERTICAL ? c.max_h : c.max_w) - main;
+        Constraints cc = VERTICAL ? Constraints(0, 0, c.max_w, avail)
+                                  : Constraints(0, 0, avail, c.max_h);
+        Size s = std::get<I>(_c).measure(cc);
+        _sz[I] = s;
+        if (I > 0) main += SP;
+        main += VERTICAL ? s.h : s.w;
+        int16_t cr = VERTICAL ? s.w : s.h;
+        if (cr > cross) cross = cr;
+    }
+
+    template <size_t... I>
+    void placeEach(int16_t& cursor, FixedTag tag, detail::Indices<I...>) {
+        (void)detail::expander{0, (placeChild<I>(cursor, tag), 0)...};
+    }
+
+    // Compile-time offsets
+    template <size_t I>
+    void placeChild(int16_t&, std::true_type) {
+        constexpr int16_t off =
+            detail::Offset<I, SP, (VERTICAL ? Cs::FH : Cs::FW)...>::value;
+        placeAt<I>((VERTICAL ? _bounds.y : _bounds.x) + off,
+                   Child<I>::FW, Child<I>::FH);
+    }
+
+    // Offsets from the measure pass
+    template <size_t I>
+    void placeChild(int16_t& cursor, std::false_type) {
+        placeAt<I>(cursor, _sz[I].w, _sz[I].h);
+        cursor += (VERTICAL ? _sz[I].h : _sz[I].w) + SP;
+    }
+
+    template <size_t I>
+    void placeAt(int16_t main_pos, int16_t cw, int16_t ch) {
+        int16_t avail = VERTICAL ? _bounds.w : _bounds.h;
+        int16_t ext = VERTICAL ? cw : ch;
+        int16_t off = 0;
+        switch (A) {
+            case Align::CENTER:  off = (avail - ext) / 2; break;
+            case Align::END:     off = avail - ext; break;
+            case Align::STRETCH: ext = avail; break;
+            default: break; // START
+        }
+        if (VERTICAL) std::get<I>(_c).place(_bounds.x + off, main_pos, ext, ch);
+        else          std::get<I>(_c).place(main_pos, _bounds.y + off, cw, ext);
+    }
+
+    template <size_t... I>
+    void drawEach(M5GFX& gfx, detail::Indices<I...>) {
+        (void)detail::expander{0, (std::get<I>(_c).draw(gfx), 0)...};
+    }
+
+    template <size_t... I>
+    void drawRegionEach(M5GFX& gfx, const Rect& r, detail::Indices<I...>) {
+        (void)detail::expander{0, (std::get<I>(_c).drawRegion(gfx, r), 0)...};
+    }
+
+    template <size_t... I>
+    void syncEach(detail::Indices<I...>) {
+        (void)detail::expander{0, (std::get<I>(_c).sync(), 0)...};
+    }
+
+    template <size_t J>
+    bool touchChild(const TouchEvent& e) {
+        return std::get<J>(_c).bounds().contains(e.x, e.y) &&
+               std::get<J>(_c).onTouch(e);
+    }
+
+    template <size_t... I>
+    bool touchEach(const TouchEvent& e, detail::Indices<I...>) {
+        bool hit = false;
+        (void)detail::expander{0, (hit = hit || touchChild<N - 1 - I>(e), 0)...};
+        return hit;
+    }
+
+    template <size_t... I>
+    bool dirtyEach(detail::Indices<I...>) const {
+        bool d = false;
+        (void)detail::expander{0, (d = d || std::get<I>(_c).isDirty(), 0)...};
+        return d;
+    }
+
+    template <size_t... I>
+    void clearEach(detail::Indices<I...>) {
+        (void)detail::expander{0, (std::get<I>(_c).clearDirty(), 0)...};
+    }
+
+    template <size_t... I>
+    uint8_t rectsEach(Rect* out, uint8_t max, detail::Indices<I...>) {
+        uint8_t n = 0;
+        (void)detail::expander{0, (n += std::get<I>(_c).dirtyRects(out + n, max - n), 0)...};
+        return n;
+    }
+
+    template <size_t... I>
+    UpdateHint hintEach(detail::Indices<I...>) const {
+        UpdateHint h = UpdateHint::NONE;
+        (void)detail::expander{0, (h = detail::worse(h, std::get<I>(_c).dirtyHint()), 0)...};
+        return h;
+    }
+
+    // Inner placement follows from the root's bounds and the children's
+    // content, so hashing content is enough. 0 if any child's is unknown.
+    template <size_t... I>
+    uint32_t hashEach(detail::Indices<I...>) const {
+        Hasher h;
+        bool known = true;
+        (void)detail::expander{0, (hashChild(h, known, std::get<I>(_c).contentHash()), 0)...};
+        return known ? h.value() : 0;
+    }
+
+    static void hashChild(Hasher& h, bool& known, uint32_t ch) {
+        if (ch == 0) known = false;
+        h.add(ch);
+    }
+
+    std::tuple<Cs...> _c;
+    Rect _bounds;
+    Size _sz[N > 0 ? N : 1];
+};
+
+template <int16_t SP, Align A, typename... Cs>
+using Col = Linear<true, SP, A, Cs...>;
+
+template <int16_t SP, Align A, typename... Cs>
+using Row = Linear<false, SP, A, Cs...>;
+
+// Adapter that lets a static tree be a Screen root or a child of a
+// dynamic layout.
+template <typename Tree>
+class StaticRoot : public Widget {
+public:
+    explicit StaticRoot(const Tree& t) : _tree(t) {}
+
+    Tree& tree() { return _tree; }
+
+    Size measure(const Constraints& c) override { return _tree.measure(c); }
+
+    void draw(M5GFX& gfx) override {
+        placeTree();
+        _tree.draw(gfx);
+        _tree.clearDirty();
+    }
+
+    void drawRegion(M5GFX& gfx, const Rect& region) override {
+        placeTree();
+        _tree.drawRegion(gfx, region);
+    }
+
+    // Collection consumes the inner dirty state; the screen redraws every
+    // reported rect in the same frame.
+    uint8_t dirtyRects(Rect* out, uint8_t max) override {
+        if (placeTree()) {
+            _hint = UpdateHint::QUALITY;
+            _tree.clearDirty();
+            return Widget::dirtyRects(out, max);
+        }
+        _hint = _tree.dirtyHint();
+        uint8_t n = _tree.dirtyRects(out, max);
+        _tree.clearDirty();
+        return n;
+    }
+
+    UpdateHint updateHint() const override { return _hint; }
+
+    bool isInteractive() const override { return true; }
+
+    void clearDirty() override {
+        placeTree();
+        _tree.clearDirty();
+        Widget::clearDirty();
+    }
+
+    uint32_t contentHash() const override { return _tree.contentHash(); }
+
+    void sync() override {
+        _tree.sync();
+        if (_tree.isDirty()) markDirty();
+    }
+
+    bool onTouch(const TouchEvent& e) override {
+        placeTree();
+        bool hit = _tree.onTouch(e);
+        if (_tree.isDirty()) markDirty();
+        return hit;
+    }
+
+private:
+    // Returns true if the tree had to be (re)placed.
+    bool placeTree() {
+        if (_placed == _bounds) return false;
+        _placed = _bounds;
+        _tree.place(_bounds.x, _bounds.y, _bounds.w, _bounds.h);
+        return true;
+    }
+
+    Tree _tree;
+    Rect _placed;
+    UpdateHint _hint = UpdateHint::QUALITY;
+};
+
+// --- Factories ---
+
+template <typename T>
+Leaf<T> leaf(const T& w) { return Leaf<T>(w); }
+
+template <int16_t W, int16_t H, typename N>
+Fixed<W, H, N> fixed(const N& n) { return Fixed<W, H, N>(n); }
+
+template <int16_t W, int16_t H>
+Space<W, H> space() { return Space<W, H>(); }
+
+template <int16_t SP = 4, Align A = Align::START, typename... Cs>
+Col<SP, A, Cs...> col(const Cs&... cs) { return Col<SP, A, Cs...>(cs...); }
+
+template <int16_t SP = 4, Align A = Align::START, typename... Cs>
+Row<SP, A, Cs...> row(const Cs&... cs) { return Row<SP, A, Cs...>(cs...); }
+
+template <typename Tree>
+StaticRoot<Tree> root(const Tree& t) { return StaticRoot<Tree>(t); }
+
+} // namespace sui
+} // namespace PaperUI
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "types.h"
+
+namespace PaperUI {
+
+// EPD modes in stats arrays, best first
+enum EpdSlot : uint8_t { EPD_SLOT_QUALITY, EPD_SLOT_TEXT, EPD_SLOT_FAST, EPD_SLOT_FASTEST, EPD_SLOTS };
+
+inline uint8_t epdSlot(epd_mode_t m) {
+    switch (m) {
+        case epd_mode_t::epd_quality: return EPD_SLOT_QUALITY;
+        case epd_mode_t::epd_text:    return EPD_SLOT_TEXT;
+        case epd_mode_t::epd_fast:    return EPD_SLOT_FAST;
+        default:                      return EPD_SLOT_FASTEST;
+    }
+}
+
+inline const char* epdSlotName(uint8_t slot) {
+    static const char* const names[EPD_SLOTS] = {"quality", "text", "fast", "fastest"};
+    return slot < EPD_SLOTS ? names[slot] : "?";
+}
+
+// Kept on each widget by the screen
+struct WidgetStats {
+    uint32_t draws = 0;
+    uint32_t draw_us = 0;              // cumulative
+    uint32_t pushes = 0;               // pushed rects this widget's change was in
+    uint32_t pixels[EPD_SLOTS] = {};   // its share of those rects, per mode
+};
+
+struct ScreenStats {
+    uint32_t frames = 0;               // render passes that pushed something
+    uint32_t partials = 0;             // partial display() calls
+    uint32_t full_refreshes = 0;
+    uint32_t merged_rects = 0;         // rects folded away by merging
+    uint32_t dropped_rects = 0;        // rects united into the last slot on overflow
+    uint32_t deferred_frames = 0;      // renders held back by the refresh budget
+    uint64_t energy = 0;               // EnergyModel units pushed
+    uint32_t pixels[EPD_SLOTS] = {};   // pushed pixels per mode, full refreshes included
+};
+
+} // namespace PaperUI
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "types.h"
+
+#ifndef PAPERUI_TEXT_LINES
+#define PAPERUI_TEXT_LINES 8   // lines a TextWidget keeps breaks for
+#endif
+
+namespace PaperUI {
+
+// Greedy word wrap: start of the line after the one starting at `s`, for
+// lines of at most `cpl` characters of a `len`-long text read through
+// `at(i)`. '\n' ends a line; otherwise a line takes as many whole words as
+// fit and the spaces it breaks on stay at its end. A word longer than a
+// line is cut. Only looks at characters from `s` on.
+template <typename CharAt>
+uint16_t wrapLine(const CharAt& at, uint16_t len, uint16_t s, uint16_t cpl) {
+    if (cpl == 0) cpl = 1;
+    uint16_t brk = s;   // just past the last space
+    for (uint16_t i = s; i < len; i++) {
+        char c = at(i);
+        if (c == '\n') return i + 1;
+        if (i - s == cpl) {
+            if (c != ' ') return brk > s ? brk : i;
+            while (i < len && at(i) == ' ') i++;
+            if (i < len && at(i) == '\n') i++;
+            return i;
+        }
+        if (c == ' ') brk = i + 1;
+    }
+    return len;
+}
+
+// End of the visible text of line [s, e): without the '\n' and the spaces
+// it broke on
+template <typename CharAt>
+uint16_t wrapLineEnd(const CharAt& at, uint16_t s, uint16_t e) {
+    if (e > s && at(e - 1) == '\n') e--;
+    while (e > s && at(e - 1) == ' ') e--;
+    return e;
+}
+
+// Cached line breaks of a NUL-terminated text, keyed on its TextKey and
+// the width in characters. Greedy breaks come out the same for any width
+// from the widest line up to the one they were made for, so redraws and
+// re-measures within that range reuse the table; only a text change or a
+// width outside it breaks the text again. Text past MAX_LINES lines is
+// dropped.
+class TextLayout {
+public:
+    static constexpr uint8_t MAX_LINES = PAPERUI_TEXT_LINES;
+
+    // True if the text had to be broken again
+    bool wrap(const char* text, const TextKey& key, uint16_t cpl) {
+        if (cpl == 0) cpl = 1;
+        if (_valid && key == _key && cpl >= _widest && cpl <= _cpl) return false;
+        auto at = [text](uint16_t i) { return text[i]; };
+        _key = key;
+        _cpl = cpl;
+        _lines = 0;
+        _widest = 0;
+        uint16_t s = 0;
+        do {
+            uint16_t e = wrapLine(at, key.len, s, cpl);
+            _start[_lines] = s;
+            _end[_lines] = wrapLineEnd(at, s, e);
+            if (_end[_lines] - s > _widest) _widest = _end[_lines] - s;
+            _lines++;
+            s = e;
+        } while (s < key.len && _lines < MAX_LINES);
+        _valid = true;
+        return true;
+    }
+
+    void invalidate() { _valid = false; }
+
+    uint8_t lines() const { return _lines; }
+    uint16_t start(uint8_t line) const { return _start[line]; }
+    uint16_t end(uint8_t line) const { return _end[line]; }
+    // Longest visible line, in characters
+    uint16_t widest() const { return _widest; }
+
+private:
+    uint16_t _start[MAX_LINES];
+    uint16_t _end[MAX_LINES];
+    TextKey _key;
+    uint16_t _cpl = 0;
+    uint16_t _widest = 0;
+    uint8_t _lines = 0;
+    bool _valid = false;
+};
+
+} // namespace PaperUI
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "node_table.h"
+
+#ifndef PAPERUI_TOUCH_GRID_ENTRIES
+#define PAPERUI_TOUCH_GRID_ENTRIES 256
+#endif
+
+namespace PaperUI {
+
+// Uniform grid over the screen mapping each cell to the interactive leaves
+// that overlap it, so a touch resolves to its target with one cell lookup
+// instead of a tree walk. Rebuilt from the NodeTable after every layout.
+//
+// Storage is compressed: `_start[c] .. _start[c + 1]` indexes the node
+// list of cell c in `_entries`, sorted by node index (pre-order), so walking
+// a cell backwards visits the topmost widget first.
+class TouchGrid {
+public:
+    static constexpr int16_t CELL = 60;
+    static constexpr int16_t COLS = (SCREEN_W + CELL - 1) / CELL;   // 9
+    static constexpr int16_t ROWS = (SCREEN_H + CELL - 1) / CELL;   // 16
+    static constexpr uint16_t CELLS = COLS * ROWS;
+    static constexpr uint16_t CAPACITY = PAPERUI_TOUCH_GRID_ENTRIES;
+
+    void build(const NodeTable& nodes) {
+        _overflow = false;
+        // Pass 1: count entries per cell
+        for (uint16_t c = 0; c <= CELLS; c++) _start[c] = 0;
+        for (uint16_t i = 0; i < nodes.size(); i++) {
+            if (!isTarget(nodes, i)) continue;
+            int16_t c0, r0, c1, r1;
+            if (!cellSpan(nodes.bounds[i], c0, r0, c1, r1)) continue;
+            for (int16_t r = r0; r <= r1; r++)
+                for (int16_t c = c0; c <= c1; c++)
+                    _start[r * COLS + c + 1]++;
+        }
+        // Prefix sums -> cell start offsets
+        for (uint16_t c = 0; c < CELLS; c++) {
+            uint16_t next = _start[c] + _start[c + 1];
+            if (next > CAPACITY) { next = CAPACITY; _overflow = true; }
+            _start[c + 1] = next;
+        }
+        // Pass 2: fill, in node order
+        uint16_t fill[CELLS];
+        for (uint16_t c = 0; c < CELLS; c++) fill[c] = _start[c];
+        for (uint16_t i = 0; i < nodes.size(); i++) {
+            if (!isTarget(nodes, i)) continue;
+            int16_t c0, r0, c1, r1;
+            if (!cellSpan(nodes.bounds[i], c0, r0, c1, r1)) continue;
+            for (int16_t r = r0; r <= r1; r++) {
+                for (int16_t c = c0; c <= c1; c++) {
+                    uint16_t cell = r * COLS + c;
+                    if (fill[cell] < _start[cell + 1]) _entries[fill[cell]++] = i;
+                }
+            }
+        }
+    }
+
+    // Nodes overlapping the cell under (x, y); iterate backwards for topmost.
+    // Returns false if the point is off screen.
+    bool cellAt(int16_t x, int16_t y, const uint16_t*& begin, const uint16_t*& end) const {
+        if (x < 0 || y < 0 || x >= COLS * CELL || y >= ROWS * CELL) return false;
+        uint16_t cell = (y / CELL) * COLS + x / CELL;
+        begin = _entries + _start[cell];
+        end = _entries + _start[cell + 1];
+        return true;
+    }
+
+    bool overflowed() const { return _overflow; }
+
+private:
+    static bool isTarget(const NodeTable& nodes, uint16_t i) {
+        return nodes.isVisibleLeaf(i) && (nodes.flags[i] & NODE_TOUCH);
+    }
+
+    static bool cellSpan(const Rect& b, int16_t& c0, int16_t& r0,
+                         int16_t& c1, int16_t& r1) {
+        if (b.w <= 0 || b.h <= 0) return false;
+        int16_t x0 = max(b.x, (int16_t)0), y0 = max(b.y, (int16_t)0);
+        int16_t x1 = min((int16_t)(b.x + b.w - 1), (int16_t)(COLS * CELL - 1));
+        int16_t y1 = min((int16_t)(b.y + b.h - 1), (int16_t)(ROWS * CELL - 1));
+        if (x1 < x0 || y1 < y0) return false;
+        c0 = x0 / CELL; r0 = y0 / CELL;
+        c1 = x1 / CELL; r1 = y1 / CELL;
+        return true;
+    }
+
+    uint16_t _start[CELLS + 1];
+    uint16_t _entries[CAPACITY];
+    bool _overflow = false;
+};
+
+} // namespace PaperUI
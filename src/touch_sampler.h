@@ -0,0 +1,159 @@
+#pragma once
+
+#include "gesture.h"
+#include <atomic>
+
+#ifndef PAPERUI_TOUCH_QUEUE
+#define PAPERUI_TOUCH_QUEUE 32
+#endif
+
+namespace PaperUI {
+
+// Lock-free single-producer / single-consumer ring of touch samples.
+// The sampler task pushes, Screen::update() pops.
+class TouchQueue {
+public:
+    static constexpr uint16_t CAPACITY = PAPERUI_TOUCH_QUEUE;
+
+    // Producer side. Returns false (and counts a drop) when full.
+    bool push(const TouchSample& s) {
+        uint16_t head = _head.load(std::memory_order_relaxed);
+        uint16_t next = (head + 1) % (CAPACITY + 1);
+        if (next == _tail.load(std::memory_order_acquire)) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _buf[head] = s;
+        _head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(TouchSample& s) {
+        uint16_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) return false;
+        s = _buf[tail];
+        _tail.store((tail + 1) % (CAPACITY + 1), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return _tail.load(std::memory_order_acquire) == _head.load(std::memory_order_acquire);
+    }
+
+    uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    TouchSample _buf[CAPACITY + 1];   // one slot kept free to tell full from empty
+    std::atomic<uint16_t> _head{0};
+    std::atomic<uint16_t> _tail{0};
+    std::atomic<uint32_t> _dropped{0};
+};
+
+// Reads the first touch point in screen coordinates. Returns false if no touch.
+using TouchReadFn = bool (*)(void* user_data, int16_t& x, int16_t& y);
+
+// Samples the touch controller on its own FreeRTOS task at a fixed period,
+// independent of the render loop, and queues timestamped samples. Only
+// changes are queued (press, release, movement), so a finger resting still
+// costs no queue space.
+//
+// The controller sits on the internal I2C bus with the RTC. With the
+// default reader, start() turns off M5Unified's own touch polling (so
+// M5.update() stops reading the controller from the loop task) until
+// stop(), and each read holds busLock(): wrap other uses of that bus from
+// other tasks (M5.Rtc) in lockBus()/unlockBus().
+class TouchSampler {
+public:
+    void setReader(TouchReadFn fn, void* data = nullptr) {
+        _read = fn;
+        _read_data = data;
+    }
+
+    bool start(uint16_t period_ms = 10, uint8_t core = 0, uint8_t priority = 2) {
+        if (_running.load()) return true;
+        _period_ms = period_ms ? period_ms : 1;
+        _stop.store(false);
+        if (!busMutex()) return false;
+        bool own = _read == readM5;
+        if (own) M5.Touch.begin(nullptr);   // M5.update() leaves the controller alone
+        _running.store(true);
+        TaskHandle_t task = nullptr;
+        if (xTaskCreatePinnedToCore(taskMain, "pui_touch", 3072, this,
+                                    priority, &task, core) != pdPASS) {
+            _running.store(false);
+            if (own) M5.Touch.begin(&M5.Display);
+            return false;
+        }
+        return true;
+    }
+
+    // Ask the task to exit after its current sample and wait for it, then
+    // hand touch back to M5Unified.
+    void stop() {
+        if (!_running.load()) return;
+        _stop.store(true);
+        while (_running.load()) vTaskDelay(1);
+        if (_read == readM5) M5.Touch.begin(&M5.Display);
+    }
+
+    bool running() const { return _running.load(); }
+
+    // Shared with the sampler task for the internal I2C bus
+    static void lockBus() { if (busMutex()) xSemaphoreTake(busMutex(), portMAX_DELAY); }
+    static void unlockBus() { if (busMutex()) xSemaphoreGive(busMutex()); }
+    TouchQueue& queue() { return _queue; }
+    const TouchQueue& queue() const { return _queue; }
+
+private:
+    static SemaphoreHandle_t busMutex() {
+        static SemaphoreHandle_t m = xSemaphoreCreateMutex();
+        return m;
+    }
+
+    static bool readM5(void*, int16_t& x, int16_t& y) {
+        lgfx::touch_point_t tp;
+        lockBus();
+        uint_fast8_t n = M5.Display.getTouch(&tp, 1);
+        unlockBus();
+        if (n == 0) return false;
+        x = tp.x;
+        y = tp.y;
+        return true;
+    }
+
+    static void taskMain(void* arg) {
+        TouchSampler* self = static_cast<TouchSampler*>(arg);
+        TickType_t wake = xTaskGetTickCount();
+        while (!self->_stop.load()) {
+            self->sampleOnce();
+            vTaskDelayUntil(&wake, pdMS_TO_TICKS(self->_period_ms));
+        }
+        self->_running.store(false);
+        vTaskDelete(nullptr);
+    }
+
+    void sampleOnce() {
+        int16_t x = 0, y = 0;
+        bool down = _read(_read_data, x, y);
+        if (!down && !_was_down) return;
+        if (down && _was_down && x == _last_x && y == _last_y) return;
+        if (_queue.push(TouchSample(x, y, millis(), down))) {
+            _was_down = down;
+            _last_x = x;
+            _last_y = y;
+        }
+    }
+
+    TouchQueue _queue;
+    TouchReadFn _read = readM5;
+    void* _read_data = nullptr;
+    std::atomic<bool> _running{false};   // set by start(), cleared by the task as it exits
+    std::atomic<bool> _stop{false};
+    uint16_t _period_ms = 10;
+    bool _was_down = false;
+    int16_t _last_x = 0;
+    int16_t _last_y = 0;
+};
+
+} // namespace PaperUI
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "stats.h"
+
+// Hot-path tracing. Build with -DPAPERUI_TRACE to record timestamped
+// begin/end events into a RAM ring; without it every PUI_TRACE_* macro
+// compiles to nothing.
+//
+//   PaperUI::Trace::dump(Serial);   // then: tools/trace_to_chrome.py
+
+#ifndef PAPERUI_TRACE_EVENTS
+#define PAPERUI_TRACE_EVENTS 256
+#endif
+
+namespace PaperUI {
+
+enum class TraceId : uint8_t {
+    FRAME,      // one render() pass
+    SYNC,       // State -> widget sync
+    MEASURE,
+    LAYOUT,     // place + layout + node table rebuild
+    DRAW,       // one widget draw; node / widget id set
+    MERGE,      // dirty rect merge
+    PUSH,       // one display() call; rect + EPD mode set
+    TOUCH,      // touch sample handling
+    COUNT
+};
+
+enum class TracePhase : uint8_t { BEGIN, END };
+
+// 20 bytes
+struct TraceEvent {
+    uint32_t us;
+    TraceId id;
+    TracePhase phase;
+    uint8_t mode;       // EpdSlot for PUSH (0 quality .. 3 fastest)
+    uint8_t _pad;
+    uint16_t node;      // node table index, or NO_NODE
+    uint16_t wid;       // Widget::id
+    Rect rect;
+};
+
+class Trace {
+public:
+    static constexpr uint16_t CAPACITY = PAPERUI_TRACE_EVENTS;
+
+    static const char* name(TraceId id) {
+        static const char* const names[] = {
+            "frame", "sync", "measure", "layout", "draw", "merge", "push", "touch"
+        };
+        return (uint8_t)id < (uint8_t)TraceId::COUNT ? names[(uint8_t)id] : "?";
+    }
+
+    static void record(TraceId id, TracePhase ph, uint16_t node = 0xFFFF,
+                       uint16_t wid = 0, const Rect& r = Rect(), uint8_t mode = 0) {
+        Ring& g = ring();
+        if (!g.enabled) return;
+        TraceEvent& e = g.events[g.head];
+        e.us = micros();
+        e.id = id;
+        e.phase = ph;
+        e.mode = mode;
+        e.node = node;
+        e.wid = wid;
+        e.rect = r;
+        g.head = (g.head + 1) % CAPACITY;
+        if (g.count < CAPACITY) g.count++;
+        else g.overwritten++;
+    }
+
+    static void enable(bool on) { ring().enabled = on; }
+    static bool enabled() { return ring().enabled; }
+    static uint16_t size() { return ring().count; }
+
+    static void clear() {
+        Ring& g = ring();
+        g.head = 0;
+        g.count = 0;
+        g.overwritten = 0;
+    }
+
+    // Oldest first. i < size()
+    static const TraceEvent& at(uint16_t i) {
+        const Ring& g = ring();
+        return g.events[(g.head + CAPACITY - g.count + i) % CAPACITY];
+    }
+
+    // One line per event:
+    //   T <us> <B|E> <name> <node> <id> <x> <y> <w> <h> <mode>
+    static void dump(Print& out = Serial, bool clear_after = true) {
+        const Ring& g = ring();
+        out.printf("[PUI] trace %u events, %lu overwritten\n",
+                   g.count, (unsigned long)g.overwritten);
+        for (uint16_t i = 0; i < g.count; i++) {
+            const TraceEvent& e = at(i);
+            out.printf("T %lu %c %s %u %u %d %d %d %d %u\n",
+                       (unsigned long)e.us, e.phase == TracePhase::BEGIN ? 'B' : 'E',
+                       name(e.id), e.node, e.wid,
+                       e.rect.x, e.rect.y, e.rect.w, e.rect.h, e.mode);
+        }
+        out.printf("[PUI] trace end\n");
+        if (clear_after) clear();
+    }
+
+private:
+    struct Ring {
+        TraceEvent events[CAPACITY];
+        uint16_t head = 0;
+        uint16_t count = 0;
+        uint32_t overwritten = 0;
+        bool enabled = true;
+    };
+
+    static Ring& ring() {
+        static Ring r;
+        return r;
+    }
+};
+
+// Records BEGIN now and END when it goes out of scope
+class TraceScope {
+public:
+    explicit TraceScope(TraceId id, uint16_t node = 0xFFFF, uint16_t wid = 0,
+                        const Rect& r = Rect(), uint8_t mode = 0)
+        : _id(id), _node(node), _wid(wid), _rect(r), _mode(mode) {
+        Trace::record(_id, TracePhase::BEGIN, _node, _wid, _rect, _mode);
+    }
+    ~TraceScope() { Trace::record(_id, TracePhase::END, _node, _wid, _rect, _mode); }
+
+private:
+    TraceId _id;
+    uint16_t _node;
+    uint16_t _wid;
+    Rect _rect;
+    uint8_t _mode;
+};
+
+} // namespace PaperUI
+
+#ifdef PAPERUI_TRACE
+#define PUI_TRACE_CAT2(a, b) a##b
+#define PUI_TRACE_CAT(a, b) PUI_TRACE_CAT2(a, b)
+#define PUI_TRACE_SCOPE(id, ...) \
+    PaperUI::TraceScope PUI_TRACE_CAT(_pui_trace_, __LINE__)(PaperUI::TraceId::id, ##__VA_ARGS__)
+#define PUI_TRACE_BEGIN(id, ...) \
+    PaperUI::Trace::record(PaperUI::TraceId::id, PaperUI::TracePhase::BEGIN, ##__VA_ARGS__)
+#define PUI_TRACE_END(id, ...) \
+    PaperUI::Trace::record(PaperUI::TraceId::id, PaperUI::TracePhase::END, ##__VA_ARGS__)
+#else
+#define PUI_TRACE_SCOPE(id, ...) ((void)0)
+#define PUI_TRACE_BEGIN(id, ...) ((void)0)
+#define PUI_TRACE_END(id, ...) ((void)0)
+#endif
@@ -16,6 +16,10 @@ namespace Colors {
     constexpr Color BLACK      = 0x000000U;
 }
 
+// M5Paper panel size in portrait orientation
+constexpr int16_t SCREEN_W = 540;
+constexpr int16_t SCREEN_H = 960;
+
 // Axis-aligned bounding rectangle
 struct Rect {
     int16_t x, y, w, h;
@@ -44,6 +48,18 @@ struct Rect {
 
     bool isEmpty() const { return w == 0 && h == 0; }
 
+    // Overlap of two rects (empty if none)
+    Rect intersect(const Rect& o) const {
+        int16_t nx = max(x, o.x);
+        int16_t ny = max(y, o.y);
+        int16_t nr = min((int16_t)(x + w), (int16_t)(o.x + o.w));
+        int16_t nb = min((int16_t)(y + h), (int16_t)(o.y + o.h));
+        if (nr <= nx || nb <= ny) return Rect();
+        return Rect(nx, ny, (int16_t)(nr - nx), (int16_t)(nb - ny));
+    }
+
+    uint32_t area() const { return (uint32_t)w * (uint32_t)h; }
+
     bool operator==(const Rect& o) const {
         return x == o.x && y == o.y && w == o.w && h == o.h;
     }
@@ -122,9 +138,55 @@ enum class UpdateHint : uint8_t {
     QUALITY = 4     // GC16 -- 16 grays, best quality, flashes
 };
 
+// Render priority. URGENT widgets bypass the refresh budget governor.
+enum class Priority : uint8_t {
+    NORMAL,
+    URGENT
+};
+
 // Callback types (function pointers -- no heap allocation)
 using OnClickCallback  = void (*)(void* user_data);
 using OnChangeCallback = void (*)(void* user_data, int32_t new_value);
 using OnKeyCallback    = void (*)(void* user_data, char key);
 
+// FNV-1a accumulator for widget content hashes. value() never returns 0,
+// which Widget::contentHash() reserves for "unknown".
+class Hasher {
+public:
+    Hasher& bytes(const void* p, size_t n) {
+        const uint8_t* b = static_cast<const uint8_t*>(p);
+        for (size_t i = 0; i < n; i++) { _h ^= b[i]; _h *= 16777619UL; }
+        return *this;
+    }
+    Hasher& str(const char* s) {
+        if (s) bytes(s, strlen(s));
+        return add((uint8_t)0);
+    }
+    template <typename T>
+    Hasher& add(const T& v) { return bytes(&v, sizeof(v)); }
+
+    uint32_t value() const { return _h ? _h : 1; }
+
+private:
+    uint32_t _h = 2166136261UL;
+};
+
+// Length + hash of a string, taken once when it is set, so a change of
+// contents is seen even when the buffer pointer stays the same (and a new
+// pointer to the same text is not).
+struct TextKey {
+    uint16_t len = 0;
+    uint32_t hash = 0;
+
+    TextKey() = default;
+    explicit TextKey(const char* s) {
+        size_t n = s ? strlen(s) : 0;
+        len = (uint16_t)n;
+        hash = Hasher().bytes(s, n).value();
+    }
+
+    bool operator==(const TextKey& o) const { return len == o.len && hash == o.hash; }
+    bool operator!=(const TextKey& o) const { return !(*this == o); }
+};
+
 } // namespace PaperUI
@@ -11,9 +11,13 @@
 #include "widgets/keyboard_widget.h"
 #include "widgets/text_area_widget.h"
 #include "widgets/battery_widget.h"
+#include "widgets/table_widget.h"
+#include "widgets/chart_widget.h"
 #include "layouts/column.h"
 #include "layouts/row.h"
 #include "layouts/stack.h"
+#include "layouts/switcher.h"
+#include "layouts/grid.h"
 #include "layouts/spacer.h"
 
 // Pool sizes — override before #include <PaperUI.h>
@@ -47,6 +51,12 @@
 #ifndef PAPERUI_POOL_STACK
 #define PAPERUI_POOL_STACK 2
 #endif
+#ifndef PAPERUI_POOL_SWITCHER
+#define PAPERUI_POOL_SWITCHER 1
+#endif
+#ifndef PAPERUI_POOL_GRID
+#define PAPERUI_POOL_GRID 1
+#endif
 #ifndef PAPERUI_POOL_SPACER
 #define PAPERUI_POOL_SPACER 4
 #endif
@@ -59,6 +69,12 @@
 #ifndef PAPERUI_POOL_BATTERY
 #define PAPERUI_POOL_BATTERY 1
 #endif
+#ifndef PAPERUI_POOL_TABLE
+#define PAPERUI_POOL_TABLE 1
+#endif
+#ifndef PAPERUI_POOL_CHART
+#define PAPERUI_POOL_CHART 2
+#endif
 
 namespace PaperUI {
 namespace ui {
@@ -74,10 +90,14 @@ struct Pools {
     StaticPool<Column,           PAPERUI_POOL_COLUMN>   columns;
     StaticPool<Row,              PAPERUI_POOL_ROW>      rows;
     StaticPool<Stack,            PAPERUI_POOL_STACK>     stacks;
+    StaticPool<Switcher,         PAPERUI_POOL_SWITCHER> switchers;
+    StaticPool<Grid,             PAPERUI_POOL_GRID>     grids;
     StaticPool<Spacer,           PAPERUI_POOL_SPACER>   spacers;
     StaticPool<KeyboardWidget,   PAPERUI_POOL_KEYBOARD> keyboards;
     StaticPool<TextAreaWidget,   PAPERUI_POOL_TEXTAREA> textAreas;
     StaticPool<BatteryWidget,    PAPERUI_POOL_BATTERY>  batteries;
+    StaticPool<TableWidget,      PAPERUI_POOL_TABLE>    tables;
+    StaticPool<ChartWidget,      PAPERUI_POOL_CHART>    charts;
 };
 
 inline Pools& pools() {
@@ -127,6 +147,14 @@ inline BatteryWidget& battery() {
     return pools().batteries.alloc();
 }
 
+inline TableWidget& table(uint16_t rows, uint8_t cols) {
+    return pools().tables.alloc().size(rows, cols);
+}
+
+inline ChartWidget& chart(int16_t w = 200, int16_t h = 60) {
+    return pools().charts.alloc().size(w, h);
+}
+
 // --- Non-variadic layout factories (zero children) ---
 
 inline Column& col(int16_t sp = 4) {
@@ -149,6 +177,15 @@ inline Stack& stack() {
     return pools().stacks.alloc();
 }
 
+inline Switcher& switcher() {
+    return pools().switchers.alloc();
+}
+
+// `cols` equal columns, rows sized to their content
+inline Grid& grid(uint8_t cols) {
+    return pools().grids.alloc().cols(cols);
+}
+
 // --- Variadic layout factories ---
 
 template <typename... Children>
@@ -184,12 +221,97 @@ Stack& stack(Children&... children) {
     return s;
 }
 
+template <typename... Pages>
+Switcher& switcher(Pages&... pages) {
+    Switcher& s = pools().switchers.alloc();
+    using expander = int[];
+    (void)expander{0, (s.add(&pages), 0)...};
+    return s;
+}
+
+// Children flow into the cells row by row
+template <typename... Children>
+Grid& grid(uint8_t cols, Children&... children) {
+    Grid& g = grid(cols);
+    using expander = int[];
+    (void)expander{0, (g.add(&children), 0)...};
+    return g;
+}
+
 // --- Other factories ---
 
 inline Spacer& spacer(int16_t w = 0, int16_t h = 0) {
     return pools().spacers.alloc().size(w, h);
 }
 
+// --- Pool telemetry ---
+
+// Usage snapshot of one pool. `name` matches the PAPERUI_POOL_<name> macro.
+struct PoolStat {
+    const char* name;
+    uint16_t count;      // slots in use by the current tree
+    uint16_t peak;       // high watermark since boot (may exceed capacity)
+    uint16_t capacity;
+    uint32_t item_size;  // bytes per slot
+};
+
+template <typename P>
+inline PoolStat poolStat(const char* name, const P& p) {
+    return { name, p.count(), p.peak(), P::capacity(), (uint32_t)P::itemSize() };
+}
+
+// Fill `out` with one entry per pool. Returns the number of entries written.
+inline uint8_t poolStats(PoolStat* out, uint8_t max) {
+    const PoolStat all[] = {
+        poolStat("TEXT",     pools().texts),
+        poolStat("VALUE",    pools().values),
+        poolStat("BUTTON",   pools().buttons),
+        poolStat("SWITCH",   pools().switches),
+        poolStat("SLIDER",   pools().sliders),
+        poolStat("CHECKBOX", pools().checkboxes),
+        poolStat("PROGRESS", pools().progressBars),
+        poolStat("COLUMN",   pools().columns),
+        poolStat("ROW",      pools().rows),
+        poolStat("STACK",    pools().stacks),
+        poolStat("SWITCHER", pools().switchers),
+        poolStat("GRID",     pools().grids),
+        poolStat("SPACER",   pools().spacers),
+        poolStat("KEYBOARD", pools().keyboards),
+        poolStat("TEXTAREA", pools().textAreas),
+        poolStat("BATTERY",  pools().batteries),
+        poolStat("TABLE",    pools().tables),
+        poolStat("CHART",    pools().charts),
+    };
+    uint8_t n = 0;
+    for (const PoolStat& s : all) {
+        if (n >= max) break;
+        out[n++] = s;
+    }
+    return n;
+}
+
+// Print pool watermarks in the format read by tools/pool_sizing.py:
+//   [PUI] pool TEXT count=3 peak=5 cap=12 item=60 bytes=720
+inline void dumpPoolStats(Print& out = Serial) {
+    PoolStat st[24];
+    uint8_t n = poolStats(st, 24);
+    uint32_t total = 0, needed = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        uint32_t bytes = st[i].capacity * st[i].item_size;
+        total += bytes;
+        needed += st[i].peak * st[i].item_size;
+        out.printf("[PUI] pool %s count=%u peak=%u cap=%u item=%lu bytes=%lu%s\n",
+                   st[i].name, st[i].count, st[i].peak, st[i].capacity,
+                   (unsigned long)st[i].item_size, (unsigned long)bytes,
+                   st[i].peak > st[i].capacity ? " OVERFLOW" : "");
+    }
+    out.printf("[PUI] pool total bytes=%lu needed=%lu\n",
+               (unsigned long)total, (unsigned long)needed);
+    out.printf("[PUI] strings used=%u peak=%u cap=%u failed=%u\n",
+               StringArena::used(), StringArena::peak(),
+               StringArena::CAPACITY, StringArena::failures());
+}
+
 inline void reset() {
     pools().texts.reset();
     pools().values.reset();
@@ -201,10 +323,14 @@ inline void reset() {
     pools().columns.reset();
     pools().rows.reset();
     pools().stacks.reset();
+    pools().switchers.reset();
+    pools().grids.reset();
     pools().spacers.reset();
     pools().keyboards.reset();
     pools().textAreas.reset();
     pools().batteries.reset();
+    pools().tables.reset();
+    pools().charts.reset();
 }
 
 } // namespace ui
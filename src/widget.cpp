@@ -1,10 +1,13 @@
 #include "widget.h"
 #include "layout.h"
+#include "node_table.h"
 
 namespace PaperUI {
 
 void Widget::markDirty() {
     _dirty = true;
+    NodeTable* t = NodeTable::active();
+    if (t && _node != NO_NODE) t->setDirty(_node, this);
     if (_parent) _parent->onChildDirty(this);
 }
 
@@ -1,10 +1,15 @@
 #pragma once
 
 #include "types.h"
+#include "gesture.h"
+#include "stats.h"
 
 namespace PaperUI {
 
 class Layout; // forward declare
+class NodeTable;
+
+constexpr uint16_t NO_NODE = 0xFFFF;
 
 class Widget {
 public:
@@ -23,6 +28,7 @@ public:
             markDirty();
             _bounds = nb;
             markDirty();
+            tree_gen()++;
         }
     }
 
@@ -31,14 +37,36 @@ public:
     // Draw this widget into the display at its _bounds position.
     virtual void draw(M5GFX& gfx) = 0;
 
+    // Redraw only the part overlapping `region` (already cleared to white).
+    // Composite leaves override this to skip unaffected content.
+    virtual void drawRegion(M5GFX& gfx, const Rect& /*region*/) { draw(gfx); }
+
     // What e-ink update mode this widget prefers.
     virtual UpdateHint updateHint() const { return UpdateHint::FAST; }
 
+    // URGENT changes are pushed at once even when the refresh budget is spent
+    Priority priority() const { return _priority; }
+    void setPriority(Priority p) { _priority = p; }
+
     // --- Dirty tracking ---
 
     bool isDirty() const { return _dirty; }
     void markDirty();
-    void clearDirty() { _dirty = false; }
+    // The screen now shows this widget's current content.
+    virtual void clearDirty() { _dirty = false; }
+
+    // Hash of everything draw() depends on except bounds, used to tell
+    // whether the panel still shows this widget after a restore. 0 means
+    // unknown: the widget is always redrawn.
+    virtual uint32_t contentHash() const { return 0; }
+
+    // Rects to redraw while dirty. Defaults to the full bounds; composite
+    // leaves may report smaller areas. Returns the number written to `out`.
+    virtual uint8_t dirtyRects(Rect* out, uint8_t max) {
+        if (max == 0) return 0;
+        out[0] = _bounds;
+        return 1;
+    }
 
     // --- State binding ---
 
@@ -50,6 +78,14 @@ public:
     // Return true if this widget consumed the event.
     virtual bool onTouch(const TouchEvent& event) { return false; }
 
+    // Leaves that override onTouch() return true so the screen indexes them
+    // for hit-testing.
+    virtual bool isInteractive() const { return false; }
+
+    // High-level gestures. Offered to the widget that captured the touch
+    // (or the deepest widget under it), then to each parent in turn.
+    virtual bool onGesture(const GestureEvent& /*g*/) { return false; }
+
     // --- Hierarchy ---
 
     virtual bool isLayout() const { return false; }
@@ -58,20 +94,54 @@ public:
 
     bool isVisible() const { return _visible; }
     void setVisible(bool v) {
-        if (_visible != v) { _visible = v; markDirty(); }
+        if (_visible != v) { _visible = v; markDirty(); tree_gen()++; }
     }
 
     void setParent(Layout* p) { _parent = p; }
     Layout* parent() const { return _parent; }
 
+    // Next child of the same parent (intrusive list owned by Layout)
+    Widget* nextSibling() const { return _next_sibling; }
+
+    // Size from the parent's last measure pass, kept on the child so
+    // layouts need no per-child arrays.
+    const Size& measuredSize() const { return _measured; }
+    void setMeasuredSize(const Size& s) { _measured = s; }
+
     // Optional user-assigned ID for widget lookup
     uint16_t id = 0;
 
+    // Bumped on any structural change (children, visibility, bounds).
+    // Screen rebuilds its node table lazily when this moves.
+    static uint32_t& tree_gen() {
+        static uint32_t g = 0;
+        return g;
+    }
+
+    // Index in the active Screen's node table, or NO_NODE
+    uint16_t node() const { return _node; }
+
+#ifdef PAPERUI_WIDGET_STATS
+    // Draw/push counters maintained by the screen
+    const WidgetStats& stats() const { return _stats; }
+    WidgetStats& stats() { return _stats; }
+#endif
+
 protected:
+    friend class NodeTable;
+    friend class Layout;
+
     Rect _bounds = {};
     Layout* _parent = nullptr;
+    Widget* _next_sibling = nullptr;
+    Size _measured = {};
     bool _dirty = true;   // starts dirty so first frame draws everything
     bool _visible = true;
+    Priority _priority = Priority::NORMAL;
+    uint16_t _node = NO_NODE;
+#ifdef PAPERUI_WIDGET_STATS
+    WidgetStats _stats;
+#endif
 };
 
 } // namespace PaperUI
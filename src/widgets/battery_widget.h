@@ -67,6 +67,8 @@ public:
 
     UpdateHint updateHint() const override { return UpdateHint::FAST; }
 
+    uint32_t contentHash() const override { return Hasher().add(_mv).value(); }
+
 private:
     int16_t _mv = 0;
     State<float>* _bound = nullptr;
@@ -75,8 +75,14 @@ public:
         }
     }
 
+    bool isInteractive() const override { return true; }
+
     UpdateHint updateHint() const override { return UpdateHint::MONO; }
 
+    uint32_t contentHash() const override {
+        return Hasher().str(_label).add(_pressed).add(_radius).value();
+    }
+
 private:
     const char* _label = "";
     bool _pressed = false;
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "../widget.h"
+#include "../state.h"
+
+namespace PaperUI {
+
+// Sparkline of a RingState: one sample every `step` pixels, newest on the
+// right. A new sample only adds a line segment, so only the strip between
+// the previous and the new point is redrawn and pushed (MONO by default).
+// When the plot is full it scrolls by three quarters of its width at once,
+// and the vertical range only grows when a sample falls outside it (with
+// headroom) and shrinks when the data uses under half of it at a scroll,
+// so neither happens every sample. Those are full redraws.
+class ChartWidget : public Widget {
+public:
+    // Fluent setters
+    ChartWidget& bind(RingStateBase& ring) {
+        _ring = &ring;
+        _last_gen = 0;
+        _first = _end = ring.oldest();
+        _scaled = false;
+        redrawAll();
+        return *this;
+    }
+    ChartWidget& size(int16_t w, int16_t h) { _pref_w = w; _pref_h = h; return *this; }
+    ChartWidget& step(uint8_t px) { _step = px ? px : 1; redrawAll(); return *this; }
+    // Fixed vertical range (no autoscale)
+    ChartWidget& range(float lo, float hi) {
+        _lo = lo;
+        _hi = hi > lo ? hi : lo + 1;
+        _auto = false;
+        _scaled = true;
+        redrawAll();
+        return *this;
+    }
+    ChartWidget& autoscale() { _auto = true; _scaled = false; redrawAll(); return *this; }
+    // Modes for appended strips and for full redraws
+    ChartWidget& stripMode(UpdateHint h) { _strip_mode = h; return *this; }
+    ChartWidget& fullMode(UpdateHint h) { _full_mode = h; return *this; }
+
+    float low() const { return _lo; }
+    float high() const { return _hi; }
+
+    // --- Widget overrides ---
+
+    Size measure(const Constraints& c) override {
+        return Size(
+            (int16_t)constrain(_pref_w, c.min_w, c.max_w),
+            (int16_t)constrain(_pref_h, c.min_h, c.max_h)
+        );
+    }
+
+    void draw(M5GFX& gfx) override {
+        gfx.fillRect(_bounds.x, _bounds.y, _bounds.w, _bounds.h, Colors::WHITE);
+        drawSegments(gfx, _first, _end);
+    }
+
+    // Segments crossing `region` (e.g. the appended strip)
+    void drawRegion(M5GFX& gfx, const Rect& region) override {
+        int16_t x0 = region.x - _bounds.x;
+        int16_t x1 = x0 + region.w;
+        uint32_t a = _first + (uint32_t)max<int16_t>(0, x0 / _step - 1);
+        uint32_t b = _first + (uint32_t)max<int16_t>(0, x1 / _step + 2);
+        drawSegments(gfx, max(a, _first), min(b, _end));
+    }
+
+    uint8_t dirtyRects(Rect* out, uint8_t max) override {
+        if (max == 0) return 0;
+        out[0] = (_full || !(_bounds == _shown)) ? _bounds : _strip.intersect(_bounds);
+        return 1;
+    }
+
+    UpdateHint updateHint() const override {
+        return (_full || !(_bounds == _shown)) ? _full_mode : _strip_mode;
+    }
+
+    void clearDirty() override {
+        _full = false;
+        _strip = Rect();
+        _shown = _bounds;
+        Widget::clearDirty();
+    }
+
+    uint32_t contentHash() const override {
+        Hasher h;
+        h.add(_lo).add(_hi).add(_step);
+        for (uint32_t s = _first; _ring && s < _end; s++) {
+            if (_ring->holds(s)) h.add(_ring->at(s));
+        }
+        return h.value();
+    }
+
+    void sync() override {
+        if (!_ring || _ring->generation() == _last_gen) return;
+        _last_gen = _ring->generation();
+        uint32_t end = _ring->appended();
+        if (end == _end) return;
+        if (end < _end) {   // cleared
+            _first = _end = _ring->oldest();
+            _scaled = false;
+            redrawAll();
+            return;
+        }
+        uint32_t prev = _end;
+        _end = end;
+        uint16_t cols = columns();
+        if (_end - _first > cols) {
+            uint16_t keep = cols / 4;
+            _first = _end - (keep ? keep : 1);
+            if (_auto) fitRange(true);
+            redrawAll();
+            return;
+        }
+        if (!fits(prev, _end)) {
+            if (_auto) fitRange(false);
+            redrawAll();
+            return;
+        }
+        // Only the new segments: from the previous last point to the newest
+        int16_t xa = xOf(prev > _first ? prev - 1 : _first);
+        int16_t xb = xOf(_end - 1);
+        Rect strip(xa, _bounds.y, xb - xa + 1, _bounds.h);
+        _strip = _strip.isEmpty() ? strip : _strip.unite(strip);
+        markDirty();
+    }
+
+private:
+    // Samples that fit across the plot
+    uint16_t columns() const {
+        return _bounds.w > 0 ? (uint16_t)((_bounds.w - 1) / _step + 1) : 0xFFFF;
+    }
+
+    int16_t xOf(uint32_t seq) const {
+        return _bounds.x + (int16_t)(seq - _first) * _step;
+    }
+
+    int16_t yOf(float v) const {
+        float f = (v - _lo) / (_hi - _lo);
+        int16_t y = _bounds.y + _bounds.h - 1 - (int16_t)(f * (_bounds.h - 1) + 0.5f);
+        return constrain(y, _bounds.y, (int16_t)(_bounds.y + _bounds.h - 1));
+    }
+
+    bool fits(uint32_t from, uint32_t to) const {
+        if (!_scaled) return false;
+        for (uint32_t s = from; s < to; s++) {
+            if (!_ring->holds(s)) continue;
+            float v = _ring->at(s);
+            if (v < _lo || v > _hi) return false;
+        }
+        return true;
+    }
+
+    // Fit the visible samples with 25% headroom. `shrink_only_loose`:
+    // keep the current range unless the data uses less than half of it.
+    void fitRange(bool shrink_only_loose) {
+        bool any = false;
+        float lo = 0, hi = 0;
+        for (uint32_t s = _first; s < _end; s++) {
+            if (!_ring->holds(s)) continue;
+            float v = _ring->at(s);
+            if (!any) { lo = hi = v; any = true; }
+            if (v < lo) lo = v;
+            if (v > hi) hi = v;
+        }
+        if (!any) return;
+        if (shrink_only_loose && _scaled && lo >= _lo && hi <= _hi &&
+            (hi - lo) * 2 >= (_hi - _lo)) {
+            return;
+        }
+        float pad = (hi - lo) * 0.25f;
+        if (pad <= 0) pad = lo != 0 ? (lo < 0 ? -lo : lo) * 0.1f : 1.0f;
+        _lo = lo - pad;
+        _hi = hi + pad;
+        _scaled = true;
+    }
+
+    void drawSegments(M5GFX& gfx, uint32_t a, uint32_t b) {
+        if (!_ring || !_scaled || b <= a) return;
+        bool have = false;
+        int16_t px = 0, py = 0;
+        for (uint32_t s = a; s < b; s++) {
+            if (!_ring->holds(s)) { have = false; continue; }
+            int16_t x = xOf(s);
+            int16_t y = yOf(_ring->at(s));
+            if (have) gfx.drawLine(px, py, x, y, _color);
+            else gfx.drawPixel(x, y, _color);
+            px = x;
+            py = y;
+            have = true;
+        }
+    }
+
+    void redrawAll() {
+        if (_auto && !_scaled && _ring) fitRange(false);
+        _full = true;
+        markDirty();
+    }
+
+    RingStateBase* _ring = nullptr;
+    uint32_t _last_gen = 0;
+    uint32_t _first = 0;   // sequence number at the left edge
+    uint32_t _end = 0;     // one past the newest drawn
+    float _lo = 0;
+    float _hi = 1;
+    Rect _strip;
+    Rect _shown;
+    int16_t _pref_w = 200;
+    int16_t _pref_h = 60;
+    Color _color = Colors::BLACK;
+    UpdateHint _strip_mode = UpdateHint::MONO;
+    UpdateHint _full_mode = UpdateHint::TEXT;
+    uint8_t _step = 2;
+    bool _auto = true;
+    bool _scaled = false;
+    bool _full = true;
+};
+
+} // namespace PaperUI
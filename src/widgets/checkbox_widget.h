@@ -73,8 +73,14 @@ public:
         return _bounds.contains(event.x, event.y);
     }
 
+    bool isInteractive() const override { return true; }
+
     UpdateHint updateHint() const override { return UpdateHint::MONO; }
 
+    uint32_t contentHash() const override {
+        return Hasher().add(_checked).str(_label).value();
+    }
+
     // Two-way bind to a State<bool>
     CheckboxWidget& bind(State<bool>& s) { _bound = &s; _last_gen = 0; return *this; }
 
@@ -89,8 +89,14 @@ public:
         }
     }
 
+    bool isInteractive() const override { return true; }
+
     UpdateHint updateHint() const override { return UpdateHint::MONO; }
 
+    uint32_t contentHash() const override {
+        return Hasher().add(_press_row).add(_press_key).value();
+    }
+
 private:
     OnKeyCallback _on_key = nullptr;
     void* _user_data = nullptr;
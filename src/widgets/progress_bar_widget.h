@@ -52,6 +52,10 @@ public:
 
     UpdateHint updateHint() const override { return UpdateHint::FAST; }
 
+    uint32_t contentHash() const override {
+        return Hasher().add(_value).add(_max).value();
+    }
+
     // Bind to a State<float> for reactive progress updates
     ProgressBarWidget& bind(State<float>& s) { _bound = &s; _last_gen = 0; return *this; }
 
@@ -91,8 +91,14 @@ public:
         return _bounds.contains(event.x, event.y);
     }
 
+    bool isInteractive() const override { return true; }
+
     UpdateHint updateHint() const override { return UpdateHint::FAST; }
 
+    uint32_t contentHash() const override {
+        return Hasher().add(_value).add(_min).add(_max).value();
+    }
+
     // Two-way bind to a State<float>
     SliderWidget& bind(State<float>& s) { _bound = &s; _last_gen = 0; return *this; }
 
@@ -62,9 +62,13 @@ public:
         return _bounds.contains(event.x, event.y);
     }
 
+    bool isInteractive() const override { return true; }
+
     // QUALITY needed to cleanly erase old thumb position
     UpdateHint updateHint() const override { return UpdateHint::QUALITY; }
 
+    uint32_t contentHash() const override { return Hasher().add(_on).value(); }
+
     // Two-way bind to a State<bool>
     SwitchWidget& bind(State<bool>& s) { _bound = &s; _last_gen = 0; return *this; }
 
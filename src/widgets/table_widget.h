@@ -0,0 +1,302 @@
+#pragma once
+
+#include "value_widget.h"
+
+#ifndef PAPERUI_TABLE_CELLS
+#define PAPERUI_TABLE_CELLS 200
+#endif
+#ifndef PAPERUI_TABLE_CELL_CHARS
+#define PAPERUI_TABLE_CELL_CHARS 8     // per cell, including the terminator
+#endif
+#ifndef PAPERUI_TABLE_COLS
+#define PAPERUI_TABLE_COLS 12
+#endif
+#ifndef PAPERUI_TABLE_BINDINGS
+#define PAPERUI_TABLE_BINDINGS 32
+#endif
+
+namespace PaperUI {
+
+// Fills `out` (cap bytes) with the text of a cell; false leaves it as is
+using TableSourceCallback = bool (*)(void* user_data, uint16_t row, uint8_t col,
+                                     char* out, uint8_t cap);
+
+// A grid of text cells in one widget: cell text lives in a flat char
+// array, changes are tracked in a bitset, and only the changed cells are
+// reported to the screen and redrawn. Cells take text or numbers (through
+// the column's printf format), follow bound State<float>s, or are pulled
+// from a data source on refresh().
+class TableWidget : public Widget {
+public:
+    static constexpr uint16_t MAX_CELLS = PAPERUI_TABLE_CELLS;
+    static constexpr uint8_t CELL_CHARS = PAPERUI_TABLE_CELL_CHARS;
+    static constexpr uint8_t MAX_COLS = PAPERUI_TABLE_COLS;
+    static constexpr uint8_t MAX_BINDINGS = PAPERUI_TABLE_BINDINGS;
+    static constexpr int16_t PAD = 4;   // between grid line and text
+
+    TableWidget() {
+        for (uint8_t c = 0; c < MAX_COLS; c++) {
+            _fmt[c] = "%.1f";
+            _int_fmt[c] = false;
+            _chars[c] = CELL_CHARS - 1;
+            _align[c] = Align::START;
+        }
+        memset(_text, 0, sizeof(_text));
+    }
+
+    // --- Configuration (call before the first layout) ---
+
+    // Fluent setters
+    TableWidget& size(uint16_t rows, uint8_t cols) {
+        _cols = min<uint8_t>(cols, (uint8_t)MAX_COLS);
+        _rows = _cols ? min<uint16_t>(rows, (uint16_t)(MAX_CELLS / _cols)) : 0;
+        updateColumns();
+        markAll();
+        return *this;
+    }
+    // Column width in characters (clipped to CELL_CHARS - 1)
+    TableWidget& width(uint8_t col, uint8_t chars) {
+        if (col < MAX_COLS) _chars[col] = min<uint8_t>(chars, (uint8_t)(CELL_CHARS - 1));
+        updateColumns();
+        return *this;
+    }
+    TableWidget& format(uint8_t col, const char* fmt) {
+        if (col < MAX_COLS) { _fmt[col] = fmt; _int_fmt[col] = formatTakesInt(fmt); }
+        return *this;
+    }
+    TableWidget& align(uint8_t col, Align a) {
+        if (col < MAX_COLS) _align[col] = a;
+        markAll();
+        return *this;
+    }
+    TableWidget& fontSize(uint8_t sz) {
+        _font_size = sz;
+        updateColumns();
+        markAll();
+        return *this;
+    }
+    // Mode for pushing changed cells (text redrawn in place)
+    TableWidget& cellMode(UpdateHint h) { _mode = h; return *this; }
+
+    TableWidget& source(TableSourceCallback cb, void* data = nullptr) {
+        _source = cb;
+        _source_data = data;
+        return *this;
+    }
+
+    // Follow a State<float>, formatted with the column's format
+    TableWidget& bind(uint16_t row, uint8_t col, State<float>& s) {
+        if (_nbound < MAX_BINDINGS && row < _rows && col < _cols) {
+            Binding& b = _bound[_nbound++];
+            b.state = &s;
+            b.last_gen = 0;
+            b.cell = (uint16_t)(row * _cols + col);
+        }
+        return *this;
+    }
+
+    // --- Cells ---
+
+    uint16_t rows() const { return _rows; }
+    uint8_t cols() const { return _cols; }
+    const char* cell(uint16_t row, uint8_t col) const {
+        return row < _rows && col < _cols ? _text[row * _cols + col] : "";
+    }
+
+    void set(uint16_t row, uint8_t col, const char* text) {
+        if (row >= _rows || col >= _cols) return;
+        store((uint16_t)(row * _cols + col), text ? text : "");
+    }
+
+    void set(uint16_t row, uint8_t col, float v) {
+        if (row >= _rows || col >= _cols) return;
+        char buf[CELL_CHARS + 8];
+        if (_int_fmt[col]) snprintf(buf, sizeof(buf), _fmt[col], (int32_t)v);
+        else snprintf(buf, sizeof(buf), _fmt[col], v);
+        store((uint16_t)(row * _cols + col), buf);
+    }
+
+    // Pull every cell from the data source; only cells whose text changed
+    // are redrawn
+    void refresh() {
+        if (!_source) return;
+        char buf[CELL_CHARS];
+        for (uint16_t r = 0; r < _rows; r++) {
+            for (uint8_t c = 0; c < _cols; c++) {
+                uint16_t i = (uint16_t)(r * _cols + c);
+                memcpy(buf, _text[i], CELL_CHARS);
+                if (_source(_source_data, r, c, buf, CELL_CHARS)) {
+                    buf[CELL_CHARS - 1] = '\0';
+                    store(i, buf);
+                }
+            }
+        }
+    }
+
+    // Inner rect of a cell (inside the grid lines)
+    Rect cellRect(uint16_t row, uint8_t col) const {
+        return Rect(_bounds.x + _col_x[col] + 1, _bounds.y + row * rowHeight() + 1,
+                    _col_x[col + 1] - _col_x[col] - 1, rowHeight() - 1);
+    }
+
+    // --- Widget overrides ---
+
+    Size measure(const Constraints& c) override {
+        return Size(
+            (int16_t)constrain((int16_t)(_col_x[_cols] + 1), c.min_w, c.max_w),
+            (int16_t)constrain((int16_t)(_rows * rowHeight() + 1), c.min_h, c.max_h)
+        );
+    }
+
+    void draw(M5GFX& gfx) override {
+        gfx.fillRect(_bounds.x, _bounds.y, _bounds.w, _bounds.h, Colors::WHITE);
+        drawCells(gfx, 0, _rows, 0, _cols);
+    }
+
+    // Only the rows and columns crossing `region`
+    void drawRegion(M5GFX& gfx, const Rect& region) override {
+        Rect part = region.intersect(_bounds);
+        if (part.isEmpty() || _rows == 0) return;
+        int16_t rh = rowHeight();
+        uint16_t r0 = (uint16_t)((part.y - _bounds.y) / rh);
+        uint16_t r1 = min<uint16_t>((uint16_t)((part.y + part.h - 1 - _bounds.y) / rh + 1), _rows);
+        uint8_t c0 = 0, c1 = _cols;
+        while (c0 < _cols && _bounds.x + _col_x[c0 + 1] < part.x) c0++;
+        while (c1 > c0 && _bounds.x + _col_x[c1 - 1] >= part.x + part.w) c1--;
+        drawCells(gfx, r0, r1, c0, c1);
+    }
+
+    // Runs of changed cells in a row make one rect each; past `max` the
+    // rest are united into the last one
+    uint8_t dirtyRects(Rect* out, uint8_t max) override {
+        if (max == 0) return 0;
+        if (_all_dirty || !(_bounds == _shown)) {
+            out[0] = _bounds;
+            return 1;
+        }
+        uint8_t n = 0;
+        for (uint16_t r = 0; r < _rows; r++) {
+            uint16_t base = (uint16_t)(r * _cols);
+            for (uint8_t c = 0; c < _cols;) {
+                if (!isCellDirty(base + c)) { c++; continue; }
+                uint8_t e = c;
+                while (e + 1 < _cols && isCellDirty(base + e + 1)) e++;
+                Rect run = cellRect(r, c).unite(cellRect(r, e));
+                if (n < max) out[n++] = run;
+                else out[max - 1] = out[max - 1].unite(run);
+                c = e + 1;
+            }
+        }
+        return n;
+    }
+
+    UpdateHint updateHint() const override { return _mode; }
+
+    void clearDirty() override {
+        memset(_cell_dirty, 0, sizeof(_cell_dirty));
+        _all_dirty = false;
+        _shown = _bounds;
+        Widget::clearDirty();
+    }
+
+    uint32_t contentHash() const override {
+        Hasher h;
+        h.add(_rows).add(_cols).add(_font_size).bytes(_chars, _cols).bytes(_align, _cols);
+        for (uint16_t i = 0; i < (uint16_t)(_rows * _cols); i++) h.str(_text[i]);
+        return h.value();
+    }
+
+    void sync() override {
+        for (uint8_t k = 0; k < _nbound; k++) {
+            Binding& b = _bound[k];
+            if (b.state->generation() == b.last_gen) continue;
+            b.last_gen = b.state->generation();
+            set((uint16_t)(b.cell / _cols), (uint8_t)(b.cell % _cols), b.state->get());
+        }
+    }
+
+private:
+    struct Binding {
+        State<float>* state;
+        uint32_t last_gen;
+        uint16_t cell;
+    };
+
+    int16_t charW() const { return 6 * _font_size; }
+    int16_t rowHeight() const { return 8 * _font_size + 2 * PAD + 1; }
+
+    void updateColumns() {
+        _col_x[0] = 0;
+        for (uint8_t c = 0; c < _cols; c++) {
+            _col_x[c + 1] = _col_x[c] + _chars[c] * charW() + 2 * PAD + 1;
+        }
+    }
+
+    bool isCellDirty(uint16_t i) const { return _cell_dirty[i >> 5] & (1UL << (i & 31)); }
+
+    // Cut to the column width so text never runs into the next cell
+    void store(uint16_t i, const char* text) {
+        char buf[CELL_CHARS];
+        uint8_t cap = _chars[i % _cols];
+        strncpy(buf, text, cap);
+        buf[cap] = '\0';
+        if (strcmp(_text[i], buf) == 0) return;
+        memcpy(_text[i], buf, cap + 1);
+        _cell_dirty[i >> 5] |= 1UL << (i & 31);
+        markDirty();
+    }
+
+    void markAll() {
+        _all_dirty = true;
+        markDirty();
+    }
+
+    // Grid lines and text of rows [r0, r1) x cols [c0, c1)
+    void drawCells(M5GFX& gfx, uint16_t r0, uint16_t r1, uint8_t c0, uint8_t c1) {
+        int16_t rh = rowHeight();
+        int16_t x0 = _bounds.x + _col_x[c0];
+        int16_t x1 = _bounds.x + _col_x[c1];
+        for (uint16_t r = r0; r <= r1; r++) {
+            gfx.drawFastHLine(x0, _bounds.y + r * rh, x1 - x0 + 1, Colors::BLACK);
+        }
+        for (uint8_t c = c0; c <= c1; c++) {
+            gfx.drawFastVLine(_bounds.x + _col_x[c], _bounds.y + r0 * rh,
+                              (r1 - r0) * rh + 1, Colors::BLACK);
+        }
+        gfx.setTextSize(_font_size);
+        gfx.setTextColor(Colors::BLACK);
+        for (uint16_t r = r0; r < r1; r++) {
+            for (uint8_t c = c0; c < c1; c++) {
+                const char* t = _text[r * _cols + c];
+                if (!t[0]) continue;
+                Rect cr = cellRect(r, c);
+                int16_t tw = (int16_t)strlen(t) * charW();
+                int16_t tx = cr.x + PAD;
+                if (_align[c] == Align::END) tx = cr.x + cr.w - PAD - tw;
+                else if (_align[c] == Align::CENTER) tx = cr.x + (cr.w - tw) / 2;
+                gfx.setTextDatum(0);
+                gfx.drawString(t, tx, cr.y + PAD);
+            }
+        }
+    }
+
+    char _text[MAX_CELLS][CELL_CHARS];
+    uint32_t _cell_dirty[(MAX_CELLS + 31) / 32] = {};
+    const char* _fmt[MAX_COLS];
+    bool _int_fmt[MAX_COLS];
+    uint8_t _chars[MAX_COLS];
+    Align _align[MAX_COLS];
+    int16_t _col_x[MAX_COLS + 1] = {};
+    Binding _bound[MAX_BINDINGS];
+    uint8_t _nbound = 0;
+    TableSourceCallback _source = nullptr;
+    void* _source_data = nullptr;
+    Rect _shown;
+    UpdateHint _mode = UpdateHint::TEXT;
+    uint16_t _rows = 0;
+    uint8_t _cols = 0;
+    uint8_t _font_size = 2;
+    bool _all_dirty = true;
+};
+
+} // namespace PaperUI
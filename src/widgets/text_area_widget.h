@@ -1,47 +1,164 @@
 #pragma once
 
 #include "../widget.h"
+#include "../text_layout.h"
 #include <cstring>
+#include <esp_heap_caps.h>
+
+#ifndef PAPERUI_TEXTAREA_INLINE
+#define PAPERUI_TEXTAREA_INLINE 256    // built-in buffer, used until capacity()
+#endif
+#ifndef PAPERUI_TEXTAREA_LINES
+#define PAPERUI_TEXTAREA_LINES 128     // indexed lines; text past them is not shown
+#endif
 
 namespace PaperUI {
 
+// Multi-line editor. Text lives in a gap buffer, so inserting or deleting
+// at the cursor moves no text except when the cursor jumps. Lines (word
+// wrapped at the width, or broken at '\n') are kept in a line-start index
+// that an edit updates from the line before the edit until the old breaks
+// line up again. Only the lines from the edit down to that point (or to
+// the bottom when the line count changed), plus the old and new cursor
+// lines, are redrawn.
 class TextAreaWidget : public Widget {
 public:
-    TextAreaWidget() { _buf[0] = '\0'; }
+    static constexpr uint16_t INLINE = PAPERUI_TEXTAREA_INLINE;
+    static constexpr uint16_t MAX_LINES = PAPERUI_TEXTAREA_LINES;
 
-    void appendChar(char c) {
-        if (_len < sizeof(_buf) - 1) {
-            _buf[_len++] = c;
-            _buf[_len] = '\0';
-            markDirty();
-        }
+    TextAreaWidget() = default;
+    // Copies (static trees) get their own buffer
+    TextAreaWidget(const TextAreaWidget& o) : Widget(o) {
+        _font_size = o._font_size;
+        _fg = o._fg;
+        _bg = o._bg;
+        _height = o._height;
+        o.moveGap(o.length());
+        if (o._heap) setCapacity(o._cap - 1, o._psram);
+        uint16_t n = min<uint16_t>(o.length(), (uint16_t)(_cap - 1));
+        memcpy(data(), o.data(), n);
+        _gap = n;
+        _gap_end = _cap;
+        _cursor = min(o._cursor, n);
     }
+    TextAreaWidget& operator=(const TextAreaWidget&) = delete;
+    ~TextAreaWidget() { if (_heap) heap_caps_free(_heap); }
 
-    void deleteChar() {
-        if (_len > 0) {
-            _len--;
-            _buf[_len] = '\0';
-            markDirty();
-        }
+    // Room for `chars` characters in a heap buffer (PSRAM if `psram` and
+    // available), keeping the text. False if memory is short.
+    bool setCapacity(uint16_t chars, bool psram = false) {
+        uint16_t cap = chars + 1;   // the gap always keeps one byte for text()'s terminator
+        if (cap <= length()) return false;
+        char* p = nullptr;
+        if (psram) p = static_cast<char*>(heap_caps_malloc(cap, MALLOC_CAP_SPIRAM));
+        if (!p) p = static_cast<char*>(heap_caps_malloc(cap, MALLOC_CAP_8BIT));
+        if (!p) return false;
+        uint16_t len = length();
+        moveGap(len);
+        memcpy(p, data(), len);
+        if (_heap) heap_caps_free(_heap);
+        _heap = p;
+        _cap = cap;
+        _psram = psram;
+        _gap = len;
+        _gap_end = cap;
+        return true;
     }
 
+    // --- Editing (at the cursor) ---
+
+    void insert(char c) {
+        if (gapSize() <= 1) return;   // full
+        moveGap(_cursor);
+        data()[_gap++] = c;
+        _cursor++;
+        edited(_cursor - 1, 1);
+    }
+
+    void insert(const char* s) {
+        while (s && *s) insert(*s++);
+    }
+
+    // Backspace
+    void deleteBack() {
+        if (_cursor == 0) return;
+        moveGap(_cursor);
+        _gap--;
+        _cursor--;
+        edited(_cursor, -1);
+    }
+
+    // Delete
+    void deleteForward() {
+        if (_cursor >= length()) return;
+        moveGap(_cursor);
+        _gap_end++;
+        edited(_cursor, -1);
+    }
+
+    void appendChar(char c) { insert(c); }
+    void deleteChar() { deleteBack(); }
+
     void clear() {
-        if (_len > 0) {
-            _len = 0;
-            _buf[0] = '\0';
-            markDirty();
-        }
+        if (length() == 0) return;
+        _gap = 0;
+        _gap_end = _cap;
+        _cursor = 0;
+        _starts[0] = 0;
+        _lines = 1;
+        _top = 0;
+        markFull();
+    }
+
+    // --- Cursor ---
+
+    uint16_t cursor() const { return _cursor; }
+
+    void setCursor(uint16_t pos) {
+        pos = min(pos, length());
+        if (pos == _cursor) return;
+        _cursor = pos;
+        cursorMoved();
+    }
+
+    void moveCursor(int16_t delta) {
+        int32_t p = (int32_t)_cursor + delta;
+        setCursor((uint16_t)constrain(p, (int32_t)0, (int32_t)length()));
+    }
+
+    // Same column on the line above (-1) or below (+1)
+    void moveLine(int8_t dir) {
+        if (!indexed()) return;
+        uint16_t l = lineOf(_cursor);
+        if ((dir < 0 && l == 0) || (dir > 0 && l + 1 >= _lines)) return;
+        uint16_t col = _cursor - _starts[l];
+        uint16_t t = l + dir;
+        setCursor(min<uint16_t>(_starts[t] + col, lastPos(t)));
     }
 
-    const char* text() const { return _buf; }
-    uint16_t length() const { return _len; }
+    // --- Access ---
+
+    uint16_t length() const { return _cap - gapSize(); }
+    uint16_t capacity() const { return _cap - 1; }
+    char charAt(uint16_t i) const { return i < _gap ? data()[i] : data()[i + gapSize()]; }
+
+    // NUL-terminated text. Moves the gap to the end (cheap when typing at
+    // the end, one memmove otherwise).
+    const char* text() const {
+        moveGap(length());
+        const_cast<char*>(data())[length()] = '\0';
+        return data();
+    }
 
     // Fluent setters
-    TextAreaWidget& fontSize(uint8_t sz) { _font_size = sz; return *this; }
-    TextAreaWidget& color(Color c) { _fg = c; return *this; }
-    TextAreaWidget& bgColor(Color c) { _bg = c; return *this; }
+    TextAreaWidget& capacity(uint16_t chars, bool psram = false) { setCapacity(chars, psram); return *this; }
+    TextAreaWidget& fontSize(uint8_t sz) { _font_size = sz; _cpl = 0; _indexed = Rect(); markFull(); return *this; }
+    TextAreaWidget& color(Color c) { _fg = c; markFull(); return *this; }
+    TextAreaWidget& bgColor(Color c) { _bg = c; markFull(); return *this; }
     TextAreaWidget& height(int16_t h) { _height = h; return *this; }
 
+    // --- Widget overrides ---
+
     Size measure(const Constraints& c) override {
         return Size(
             c.max_w,
@@ -50,65 +167,314 @@ public:
     }
 
     void draw(M5GFX& gfx) override {
-        // Background
+        ensureIndex();
         gfx.fillRect(_bounds.x, _bounds.y, _bounds.w, _bounds.h, _bg);
-        // Border
         gfx.drawRect(_bounds.x, _bounds.y, _bounds.w, _bounds.h, Colors::BLACK);
+        drawLines(gfx, _top, (uint16_t)(_top + visibleLines()));
+    }
 
-        int16_t char_w = CHAR_W * _font_size;
-        int16_t char_h = CHAR_H * _font_size;
-        int16_t inner_w = _bounds.w - 2 * PAD;
-        int16_t chars_per_line = (inner_w > 0 && char_w > 0) ? inner_w / char_w : 1;
-        if (chars_per_line < 1) chars_per_line = 1;
-
-        gfx.setTextSize(_font_size);
-        gfx.setTextColor(_fg);
-        gfx.setTextDatum(0);
+    // Only the lines crossing `region`
+    void drawRegion(M5GFX& gfx, const Rect& region) override {
+        ensureIndex();
+        Rect inner = innerRect().intersect(region);
+        if (!inner.isEmpty()) gfx.fillRect(inner.x, inner.y, inner.w, inner.h, _bg);
+        gfx.drawRect(_bounds.x, _bounds.y, _bounds.w, _bounds.h, Colors::BLACK);
+        int16_t lh = lineHeight();
+        int16_t y0 = _bounds.y + PAD;
+        int16_t a = max<int16_t>(0, (region.y - y0) / lh);
+        int16_t b = (region.y + region.h - y0 + lh - 1) / lh;
+        if (b <= a) return;
+        drawLines(gfx, (uint16_t)(_top + a), (uint16_t)(_top + min<int16_t>(b, visibleLines())));
+    }
 
-        int16_t tx = _bounds.x + PAD;
-        int16_t ty = _bounds.y + PAD;
-        int16_t max_y = _bounds.y + _bounds.h - PAD - char_h;
-
-        // Word-wrap: draw chars_per_line characters per line
-        uint16_t pos = 0;
-        while (pos < _len && ty <= max_y) {
-            uint16_t line_len = _len - pos;
-            if (line_len > (uint16_t)chars_per_line) line_len = chars_per_line;
-
-            // Draw one line
-            char tmp[64];
-            if (line_len > sizeof(tmp) - 1) line_len = sizeof(tmp) - 1;
-            memcpy(tmp, _buf + pos, line_len);
-            tmp[line_len] = '\0';
-            gfx.drawString(tmp, tx, ty);
-
-            pos += line_len;
-            ty += char_h + 2;
+    // The changed line range and the old and new cursor lines
+    uint8_t dirtyRects(Rect* out, uint8_t max) override {
+        if (max == 0) return 0;
+        ensureIndex();
+        if (_full || !(_bounds == _shown)) {
+            out[0] = _bounds;
+            return 1;
         }
-
-        // Draw cursor underscore after last character
-        int16_t cursor_col = _len % chars_per_line;
-        int16_t cursor_row = _len / chars_per_line;
-        int16_t cx = _bounds.x + PAD + cursor_col * char_w;
-        int16_t cy = _bounds.y + PAD + cursor_row * (char_h + 2);
-        if (cy <= max_y) {
-            gfx.fillRect(cx, cy + char_h - 2, char_w, 2, _fg);
+        Rect r[3];
+        uint8_t n = 0;
+        if (_dirty_to > _dirty_from) r[n++] = linesRect(_dirty_from, _dirty_to);
+        uint16_t cl = lineOf(_cursor);
+        r[n++] = linesRect(_shown_cursor_line, _shown_cursor_line + 1);
+        if (cl != _shown_cursor_line) r[n++] = linesRect(cl, cl + 1);
+        // Fold overlapping rects together
+        uint8_t k = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            if (r[i].isEmpty()) continue;
+            bool merged = false;
+            for (uint8_t j = 0; j < k && !merged; j++) {
+                if (out[j].intersects(r[i])) { out[j] = out[j].unite(r[i]); merged = true; }
+            }
+            if (merged) continue;
+            if (k < max) out[k++] = r[i];
+            else out[max - 1] = out[max - 1].unite(r[i]);
         }
+        return k;
+    }
+
+    void clearDirty() override {
+        _full = false;
+        _dirty_from = _dirty_to = 0;
+        _shown = _bounds;
+        _shown_cursor_line = indexed() ? lineOf(_cursor) : 0;
+        Widget::clearDirty();
     }
 
     UpdateHint updateHint() const override { return UpdateHint::TEXT; }
 
+    uint32_t contentHash() const override {
+        Hasher h;
+        for (uint16_t i = 0; i < length(); i++) h.add(charAt(i));
+        return h.add(_cursor).add(_top).add(_font_size).add(_fg).add(_bg).value();
+    }
+
+    // Tap to place the cursor
+    bool onTouch(const TouchEvent& event) override {
+        if (event.action != TouchAction::UP || !_bounds.contains(event.x, event.y)) {
+            return event.action == TouchAction::DOWN && _bounds.contains(event.x, event.y);
+        }
+        ensureIndex();
+        if (!indexed()) return true;
+        uint16_t l = _top + max<int16_t>(0, (event.y - _bounds.y - PAD) / lineHeight());
+        if (l >= _lines) l = _lines - 1;
+        uint16_t col = max<int16_t>(0, (event.x - _bounds.x - PAD + charW() / 2) / charW());
+        setCursor(min<uint16_t>(_starts[l] + col, lastPos(l)));
+        return true;
+    }
+
+    bool isInteractive() const override { return true; }
+
 private:
-    char _buf[256];
-    uint16_t _len = 0;
+    static constexpr int16_t PAD = 6;
+    static constexpr int16_t CHAR_W = 6;
+    static constexpr int16_t CHAR_H = 8;
+    static constexpr int16_t LINE_GAP = 2;
+    static constexpr uint16_t TO_END = 0xFFFF;
+
+    char* data() { return _heap ? _heap : _inline; }
+    const char* data() const { return _heap ? _heap : _inline; }
+    uint16_t gapSize() const { return _gap_end - _gap; }
+
+    // Put the gap at logical position `pos`
+    void moveGap(uint16_t pos) const {
+        char* d = const_cast<char*>(data());
+        if (pos < _gap) {
+            uint16_t n = _gap - pos;
+            memmove(d + _gap_end - n, d + pos, n);
+            _gap = pos;
+            _gap_end -= n;
+        } else if (pos > _gap) {
+            uint16_t n = pos - _gap;
+            memmove(d + _gap, d + _gap_end, n);
+            _gap += n;
+            _gap_end += n;
+        }
+    }
+
+    int16_t charW() const { return CHAR_W * _font_size; }
+    int16_t lineHeight() const { return CHAR_H * _font_size + LINE_GAP; }
+    Rect innerRect() const { return Rect(_bounds.x + 1, _bounds.y + 1, _bounds.w - 2, _bounds.h - 2); }
+
+    int16_t visibleLines() const {
+        int16_t h = _bounds.h - 2 * PAD + LINE_GAP;
+        return h > 0 ? h / lineHeight() : 0;
+    }
+
+    uint16_t charsPerLine() const {
+        int16_t w = _bounds.w - 2 * PAD;
+        return (uint16_t)(w > charW() ? w / charW() : 1);
+    }
+
+    bool indexed() const { return _cpl != 0; }
+
+    // Start of the line after the one starting at `s`
+    uint16_t nextLine(uint16_t s) const {
+        return wrapLine([this](uint16_t i) { return charAt(i); }, length(), s, _cpl);
+    }
+
+    // True if a line starts at `e` (the end of the text) after the line
+    // [s, e): the last line ended with '\n' or filled the width
+    bool opensLine(uint16_t s, uint16_t e) const {
+        return e > s && (charAt(e - 1) == '\n' || e - s >= _cpl);
+    }
+
+    // Index of the line holding position `pos`
+    uint16_t lineOf(uint16_t pos) const {
+        uint16_t lo = 0, hi = _lines;
+        while (hi - lo > 1) {
+            uint16_t mid = (lo + hi) / 2;
+            if (_starts[mid] <= pos) lo = mid; else hi = mid;
+        }
+        return lo;
+    }
+
+    // End of the text shown on line `l`
+    uint16_t lineEnd(uint16_t l) const {
+        uint16_t e = l + 1 < _lines ? _starts[l + 1] : length();
+        return wrapLineEnd([this](uint16_t i) { return charAt(i); }, _starts[l], e);
+    }
+
+    // Last cursor position that stays on line `l`
+    uint16_t lastPos(uint16_t l) const {
+        return l + 1 < _lines ? _starts[l + 1] - 1 : length();
+    }
+
+    // Starts of the lines after line `from`, into `out`
+    uint16_t breakFrom(uint16_t from, uint16_t* out, uint16_t room) const {
+        uint16_t n = 0, len = length();
+        uint16_t s = _starts[from];
+        while (n < room) {
+            uint16_t e = nextLine(s);
+            if (e >= len && !opensLine(s, e)) break;
+            out[n++] = e;
+            s = e;
+        }
+        return n;
+    }
+
+    void ensureIndex() {
+        if (_bounds == _indexed && indexed()) return;
+        _indexed = _bounds;
+        uint16_t cpl = charsPerLine();
+        if (cpl != _cpl) {
+            _cpl = cpl;
+            _starts[0] = 0;
+            _lines = 1 + breakFrom(0, _starts + 1, MAX_LINES - 1);
+            _full = true;
+        }
+        if (scrollToCursor()) _full = true;
+    }
+
+    // After inserting (delta 1) or deleting (-1) at `pos`: re-break from
+    // the line before the edit until a new break lands on an old break
+    // past the edit (shifted by delta); everything after that is kept.
+    void edited(uint16_t pos, int16_t delta) {
+        if (!indexed()) { markFull(); return; }
+        uint16_t k = lineOf(pos);
+        uint16_t from = k > 0 ? k - 1 : 0;
+        uint16_t fresh[MAX_LINES];
+        uint16_t n = 0, len = length(), s = _starts[from];
+        uint16_t j = k + 1;     // next old break to compare against
+        bool converged = false;
+        while (from + 1 + n < MAX_LINES) {
+            uint16_t e = nextLine(s);
+            if (e >= len && !opensLine(s, e)) break;
+            while (j < _lines && (_starts[j] <= pos || (int32_t)_starts[j] + delta < e)) j++;
+            if (j < _lines && (int32_t)_starts[j] + delta == e) { converged = true; break; }
+            fresh[n++] = e;
+            s = e;
+        }
+        bool first_moved = k > from && (n == 0 || fresh[0] != _starts[k]);
+        uint16_t old_lines = _lines;
+        uint16_t kept = converged ? _lines - j : 0;
+        uint16_t total = min<uint16_t>(from + 1 + n + kept, (uint16_t)MAX_LINES);
+        if (converged) {
+            // Shift the untouched tail into place, then apply the delta
+            uint16_t dst = from + 1 + n;
+            memmove(_starts + dst, _starts + j, (total - dst) * sizeof(uint16_t));
+            for (uint16_t i = dst; i < total; i++) _starts[i] += delta;
+        }
+        memcpy(_starts + from + 1, fresh, n * sizeof(uint16_t));
+        _lines = total;
+
+        // Changed lines: to the convergence point, to the bottom if the
+        // lines after it moved, or to the end of the text
+        uint16_t a = first_moved ? from : k;
+        uint16_t b = !converged ? max(total, old_lines)
+                   : total == old_lines ? from + 1 + n : TO_END;
+        addDirtyLines(a, b);
+        if (scrollToCursor()) markFull();
+        markDirty();
+    }
+
+    void cursorMoved() {
+        if (indexed() && scrollToCursor()) markFull();
+        markDirty();
+    }
+
+    // Keep the cursor line on screen; true if the view moved
+    bool scrollToCursor() {
+        uint16_t l = lineOf(_cursor);
+        int16_t v = max<int16_t>(visibleLines(), 1);
+        uint16_t top = _top;
+        if (l < top) top = l;
+        else if (l >= top + v) top = l - v + 1;
+        if (top == _top) return false;
+        _top = top;
+        return true;
+    }
+
+    void addDirtyLines(uint16_t a, uint16_t b) {
+        if (_dirty_to <= _dirty_from) { _dirty_from = a; _dirty_to = b; return; }
+        _dirty_from = min(_dirty_from, a);
+        _dirty_to = max(_dirty_to, b);
+    }
+
+    void markFull() {
+        _full = true;
+        markDirty();
+    }
+
+    // Screen rect of lines [a, b), clipped to the view (TO_END: to the bottom)
+    Rect linesRect(uint16_t a, uint16_t b) const {
+        int16_t v = visibleLines();
+        int32_t ra = max<int32_t>((int32_t)a - _top, 0);
+        int32_t rb = b == TO_END ? v : min<int32_t>((int32_t)b - _top, v);
+        if (rb <= ra) return Rect();
+        int16_t y = _bounds.y + PAD + (int16_t)ra * lineHeight();
+        int16_t bottom = b == TO_END ? _bounds.y + _bounds.h - PAD
+                                     : _bounds.y + PAD + (int16_t)rb * lineHeight();
+        return Rect(_bounds.x + PAD, y, _bounds.w - 2 * PAD, bottom - y);
+    }
+
+    void drawLines(M5GFX& gfx, uint16_t a, uint16_t b) {
+        if (!indexed()) return;
+        gfx.setTextSize(_font_size);
+        gfx.setTextColor(_fg);
+        gfx.setTextDatum(0);
+        uint16_t cl = lineOf(_cursor);
+        for (uint16_t l = a; l < b && l < _lines; l++) {
+            int16_t y = _bounds.y + PAD + (l - _top) * lineHeight();
+            char tmp[128];
+            uint16_t s = _starts[l], e = lineEnd(l), n = 0;
+            for (uint16_t i = s; i < e && n < _cpl && n < sizeof(tmp) - 1; i++) tmp[n++] = charAt(i);
+            tmp[n] = '\0';
+            if (n) gfx.drawString(tmp, _bounds.x + PAD, y);
+            if (l == cl) {
+                // Past the last column (on the spaces a line broke on):
+                // at the right edge
+                int16_t cx = _bounds.x + PAD + min<uint16_t>(_cursor - s, _cpl) * charW();
+                int16_t cw = min<int16_t>(charW(), _bounds.x + _bounds.w - 1 - cx);
+                gfx.fillRect(cx, y + CHAR_H * _font_size - 2, cw, 2, _fg);
+            }
+        }
+    }
+
+    char _inline[INLINE];
+    char* _heap = nullptr;
+    uint16_t _cap = INLINE;
+    mutable uint16_t _gap = 0;        // gap is [_gap, _gap_end)
+    mutable uint16_t _gap_end = INLINE;
+    uint16_t _cursor = 0;
+    uint16_t _starts[MAX_LINES];
+    uint16_t _lines = 0;
+    uint16_t _cpl = 0;                // chars per line the index was built for; 0 = none
+    uint16_t _top = 0;                // first line shown
+    uint16_t _dirty_from = 0;         // changed lines [from, to)
+    uint16_t _dirty_to = 0;
+    uint16_t _shown_cursor_line = 0;
+    Rect _shown;
+    Rect _indexed;                    // bounds the index and scroll were set for
     uint8_t _font_size = 2;
     Color _fg = Colors::BLACK;
     Color _bg = Colors::WHITE;
     int16_t _height = 120;
-
-    static constexpr int16_t PAD = 6;
-    static constexpr int16_t CHAR_W = 6;
-    static constexpr int16_t CHAR_H = 8;
+    bool _psram = false;
+    bool _full = true;
 };
 
 } // namespace PaperUI
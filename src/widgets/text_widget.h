@@ -2,14 +2,24 @@
 
 #include "../widget.h"
 #include "../state.h"
+#include "../text_layout.h"
 
 namespace PaperUI {
 
+// A label. Text wider than the space it is given wraps at word
+// boundaries (and at '\n') into as many lines as it needs, measured in
+// measure(); the breaks are cached, so redraws do not break it again.
 class TextWidget : public Widget {
 public:
-    void setText(const char* text) {
-        if (_text != text) {
-            _text = text;
+    // Redraws when the text changes, judged by contents: the same buffer
+    // rewritten in place counts, a copy of the current text does not.
+    void setText(const char* text) { setText(text, TextKey(text)); }
+
+    void setText(const char* text, const TextKey& k) {
+        if (!text) text = "";
+        _text = text;
+        if (k != _key) {
+            _key = k;
             markDirty();
         }
     }
@@ -35,8 +45,14 @@ public:
     TextWidget& bgColor(Color c) { setBgColor(c); return *this; }
 
     Size measure(const Constraints& c) override {
-        int16_t tw = CHAR_W * strlen(_text) * _font_size;
+        int16_t cw = CHAR_W * _font_size;
+        int16_t tw = cw * _key.len;
         int16_t th = CHAR_H * _font_size;
+        _wrap.wrap(_text, _key, (uint16_t)max<int16_t>(c.max_w / cw, 1));
+        if (_wrap.lines() > 1) {
+            tw = cw * _wrap.widest();
+            th = _wrap.lines() * lineHeight() - LINE_GAP;
+        }
         return Size(
             (int16_t)constrain(tw, c.min_w, c.max_w),
             (int16_t)constrain(th, c.min_h, c.max_h)
@@ -48,18 +64,37 @@ public:
         gfx.setTextSize(_font_size);
         gfx.setTextColor(_fg);
         gfx.setTextDatum(0);
-        gfx.drawString(_text, _bounds.x, _bounds.y);
+        // Room for one line only: draw it whole, as a single-line label
+        if (_bounds.h < 2 * lineHeight() - LINE_GAP) {
+            gfx.drawString(_text, _bounds.x, _bounds.y);
+            return;
+        }
+        int16_t cw = CHAR_W * _font_size;
+        _wrap.wrap(_text, _key, (uint16_t)max<int16_t>(_bounds.w / cw, 1));
+        int16_t y = _bounds.y;
+        for (uint8_t l = 0; l < _wrap.lines(); l++, y += lineHeight()) {
+            if (l > 0 && y + CHAR_H * _font_size > _bounds.y + _bounds.h) break;
+            char line[128];
+            uint16_t n = min<uint16_t>(_wrap.end(l) - _wrap.start(l), (uint16_t)(sizeof(line) - 1));
+            memcpy(line, _text + _wrap.start(l), n);
+            line[n] = '\0';
+            gfx.drawString(line, _bounds.x, y);
+        }
     }
 
     UpdateHint updateHint() const override { return UpdateHint::TEXT; }
 
+    uint32_t contentHash() const override {
+        return Hasher().add(_key.hash).add(_key.len).add(_fg).add(_bg).add(_font_size).value();
+    }
+
     // Bind to a State<const char*> for reactive text updates
     TextWidget& bind(State<const char*>& s) { _bound = &s; _last_gen = 0; return *this; }
 
     void sync() override {
         if (_bound && _bound->generation() != _last_gen) {
             _last_gen = _bound->generation();
-            setText(_bound->get());
+            setText(_bound->get(), _bound->key());
         }
     }
 
@@ -67,9 +102,14 @@ protected:
     uint8_t fontSize_() const { return _font_size; }
     static constexpr int16_t CHAR_W = 6;
     static constexpr int16_t CHAR_H = 8;
+    static constexpr int16_t LINE_GAP = 2;
 
 private:
+    int16_t lineHeight() const { return CHAR_H * _font_size + LINE_GAP; }
+
     const char* _text = "";
+    TextKey _key = TextKey("");
+    TextLayout _wrap;
     Color _fg = Colors::BLACK;
     Color _bg = Colors::WHITE;
     uint8_t _font_size = 2;
@@ -1,41 +1,60 @@
 #pragma once
 
 #include "text_widget.h"
+#include "../idle.h"
 #include <cstdio>
 #include <cstring>
 
 namespace PaperUI {
 
+// True if the first conversion in `fmt` is an integer one (%d, %i, %u,
+// %ld, %li, %lu), so the value is passed as int32_t
+inline bool formatTakesInt(const char* fmt) {
+    const char* p = fmt;
+    while (*p) {
+        if (*p == '%') {
+            p++;
+            // skip flags/width/precision
+            while (*p == '-' || *p == '+' || *p == ' ' || *p == '0' || *p == '#') p++;
+            while (*p >= '0' && *p <= '9') p++;
+            if (*p == '.') { p++; while (*p >= '0' && *p <= '9') p++; }
+            // skip length modifiers
+            while (*p == 'l' || *p == 'h') p++;
+            return *p == 'd' || *p == 'i' || *p == 'u';
+        }
+        p++;
+    }
+    return false;
+}
+
 class ValueWidget : public TextWidget {
 public:
     ValueWidget() {
         text(_buf);
     }
 
+    // Copies (e.g. into static trees) must display their own buffer
+    ValueWidget(const ValueWidget& o) : TextWidget(o) {
+        memcpy(_buf, o._buf, sizeof(_buf));
+        _val = o._val;
+        _fmt = o._fmt;
+        _int_fmt = o._int_fmt;
+        _min_chars = o._min_chars;
+        _bound_val = o._bound_val;
+        _last_val_gen = o._last_val_gen;
+        _filter = o._filter;
+        _pending = o._pending;
+        text(_buf);
+    }
+
     ValueWidget& format(const char* fmt) {
         _fmt = fmt;
-        // Detect integer format specifiers (%d, %i, %u, %ld, %li, %lu)
-        _int_fmt = false;
-        const char* p = fmt;
-        while (*p) {
-            if (*p == '%') {
-                p++;
-                // skip flags/width/precision
-                while (*p == '-' || *p == '+' || *p == ' ' || *p == '0' || *p == '#') p++;
-                while (*p >= '0' && *p <= '9') p++;
-                if (*p == '.') { p++; while (*p >= '0' && *p <= '9') p++; }
-                // skip length modifiers
-                while (*p == 'l' || *p == 'h') p++;
-                if (*p == 'd' || *p == 'i' || *p == 'u') {
-                    _int_fmt = true;
-                }
-                break;
-            }
-            p++;
-        }
+        _int_fmt = formatTakesInt(fmt);
         return *this;
     }
 
+    // Redraws only if the formatted text changes (21.04 -> 21.03 with
+    // "%.1f" does not).
     ValueWidget& operator=(float v) {
         if (v == _val && _buf[0] != '\0') return *this;
         _val = v;
@@ -44,7 +63,7 @@ public:
         } else {
             snprintf(_buf, sizeof(_buf), _fmt, v);
         }
-        markDirty();
+        setText(_buf);
         return *this;
     }
 
@@ -74,12 +93,48 @@ public:
     ValueWidget& bgColor(Color c) { TextWidget::bgColor(c); return *this; }
 
     // Bind to a State<float> for reactive value updates
-    ValueWidget& bind(State<float>& s) { _bound_val = &s; _last_val_gen = 0; return *this; }
+    ValueWidget& bind(State<float>& s) {
+        _bound_val = &s;
+        _last_val_gen = 0;
+        _filter.reset();
+        return *this;
+    }
+
+    // Ignore bound changes within `abs` (or `rel` as a fraction of the
+    // shown value) of the last shown value.
+    ValueWidget& deadband(float abs, float rel = 0) {
+        _filter.abs_deadband = abs;
+        _filter.rel_deadband = rel;
+        return *this;
+    }
+
+    // Show at most one bound update per `ms`; the latest value goes out
+    // when the interval expires.
+    ValueWidget& minInterval(uint16_t ms) { _filter.min_interval_ms = ms; return *this; }
 
     void sync() override {
-        if (_bound_val && _bound_val->generation() != _last_val_gen) {
-            _last_val_gen = _bound_val->generation();
-            *this = _bound_val->get();
+        if (!_bound_val) return;
+        if (_bound_val->generation() == _last_val_gen && !_pending) return;
+        _last_val_gen = _bound_val->generation();
+        float v = _bound_val->get();
+        if (!_filter.active()) {
+            *this = v;
+            return;
+        }
+        uint32_t now = millis();
+        switch (_filter.check(v, now)) {
+            case BindingFilter::ACCEPT:
+                _pending = false;
+                _filter.accepted(v, now);
+                *this = v;
+                break;
+            case BindingFilter::REJECT:
+                _pending = false;
+                break;
+            case BindingFilter::LATER:
+                _pending = true;
+                requestWakeAt(_filter.retryAt());
+                break;
         }
     }
 
@@ -91,6 +146,8 @@ private:
     uint8_t _min_chars = 6;
     State<float>* _bound_val = nullptr;
     uint32_t _last_val_gen = 0;
+    BindingFilter _filter;
+    bool _pending = false;   // held back by minInterval
 };
 
 } // namespace PaperUI
@@ -0,0 +1,131 @@
+// Rebuilding a screen from the same pools after ui::reset() must give fresh
+// widgets: no children, id or grid cells left over from the previous tree.
+//
+// Runs on the host against the stubs in tests/host/stub; from the repo root:
+//   g++ -std=gnu++11 -Wall -Itests/host/stub -I. -o pool_rebuild_test
+//       tests/host/pool_rebuild_test.cpp tests/host/stub/stub.cpp src/widget.cpp
+//   ./pool_rebuild_test
+
+#include <PaperUI.h>
+
+using namespace PaperUI;
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+// Children of `l` in list order must be exactly `want`
+static bool childrenAre(const Layout& l, Widget* const* want, uint16_t n) {
+    if (l.childCount() != n) return false;
+    uint16_t i = 0;
+    for (Widget* c = l.firstChild(); c; c = c->nextSibling()) {
+        if (i >= n || c != want[i] || c->parent() != &l) return false;
+        i++;
+    }
+    return i == n;
+}
+
+static void columnReorderedAndShrunk() {
+    ui::reset();
+    TextWidget& a = ui::text("a");
+    TextWidget& b = ui::text("b");
+    a.id = 1;
+    b.id = 2;
+    Column& c1 = ui::col(4, a, b);
+    Widget* first[] = {&a, &b};
+    CHECK(childrenAre(c1, first, 2));
+
+    // Same pools, reversed: the slots that held a and b now hold b2 and a2
+    ui::reset();
+    TextWidget& b2 = ui::text("b");
+    TextWidget& a2 = ui::text("a");
+    CHECK(&b2 == &a && &a2 == &b);
+    CHECK(b2.id == 0 && a2.id == 0);
+    Column& c2 = ui::col(4, b2, a2);
+    CHECK(&c2 == &c1);
+    Widget* reversed[] = {&b2, &a2};
+    CHECK(childrenAre(c2, reversed, 2));
+
+    // Shrunk to one child
+    ui::reset();
+    TextWidget& only = ui::text("only");
+    Column& c3 = ui::col(4, only);
+    Widget* one[] = {&only};
+    CHECK(childrenAre(c3, one, 1));
+    CHECK(only.nextSibling() == nullptr);
+
+    // Empty
+    ui::reset();
+    Column& c4 = ui::col(4);
+    CHECK(c4.childCount() == 0 && c4.firstChild() == nullptr);
+}
+
+static void gridStartsEmpty() {
+    ui::reset();
+    ui::grid(2, ui::text("1"), ui::text("2"), ui::text("3"), ui::text("4"));
+
+    ui::reset();
+    TextWidget& x = ui::text("x");
+    Grid& g = ui::grid(2, x);
+    CHECK(g.childCount() == 1);
+    CHECK(g.rowCount() == 1);
+    g.measure(Constraints(0, 0, 200, 200));
+    g.place(0, 0, 200, 200);
+    g.layout();
+    CHECK(g.childAt(0, 0) == &x);
+    CHECK(g.childAt(1, 0) == nullptr);
+}
+
+static void switcherShowsFirstPage() {
+    ui::reset();
+    ui::switcher(ui::text("p0"), ui::text("p1"), ui::text("p2")).select(2);
+
+    ui::reset();
+    TextWidget& p0 = ui::text("q0");
+    TextWidget& p1 = ui::text("q1");
+    Switcher& s = ui::switcher(p0, p1);
+    CHECK(s.childCount() == 2);
+    CHECK(s.active() == 0);
+    CHECK(s.activePage() == &p0);
+    CHECK(p0.isVisible() && !p1.isVisible());
+}
+
+static Widget& settings(bool reordered) {
+    TextWidget& title = ui::text("Settings", 3);
+    TextWidget& wifi = ui::text("Wifi");
+    TextWidget& bt = ui::text("Bluetooth");
+    ButtonWidget& ok = ui::button("OK");
+    ok.id = 7;
+    if (reordered) return ui::col(6, title, bt, ok);
+    return ui::col(6, title, wifi, bt, ok);
+}
+
+static void screenRebuild() {
+    ui::reset();
+    Screen screen;
+    screen.begin();
+    screen.root(settings(false));
+    CHECK(screen.find(7) != nullptr);
+
+    screen.beginRebuild();
+    ui::reset();
+    Widget& root = settings(true);
+    screen.reconcile(root);
+    CHECK(static_cast<Layout&>(root).childCount() == 3);
+    CHECK(screen.find(7) == static_cast<Layout&>(root).child(2));
+}
+
+int main() {
+    columnReorderedAndShrunk();
+    gridStartsEmpty();
+    switcherShowsFirstPage();
+    screenRebuild();
+    if (failures) {
+        printf("%d failure(s)\n", failures);
+        return 1;
+    }
+    printf("ok\n");
+    return 0;
+}
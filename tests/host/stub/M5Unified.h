@@ -0,0 +1,60 @@
+// Host stub of the M5Unified / Arduino / FreeRTOS surface PaperUI uses, so
+// the library compiles and runs on a PC for tests. Drawing does nothing.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+using std::min; using std::max;
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+unsigned long millis(); unsigned long micros();
+#define RTC_DATA_ATTR
+#define IRAM_ATTR
+class Print { public:
+  size_t printf(const char*, ...) __attribute__((format(printf,2,3)));
+  size_t print(const char*); size_t println(const char* = ""); size_t write(uint8_t);
+  size_t print(int); size_t print(unsigned); size_t print(long); size_t print(unsigned long);
+};
+class HardwareSerial : public Print {};
+extern HardwareSerial Serial;
+enum epd_mode_t { epd_quality, epd_text, epd_fast, epd_fastest };
+namespace lgfx { struct rgb565_t { uint16_t raw; rgb565_t(){} rgb565_t(uint8_t r,uint8_t g,uint8_t b):raw(0){} }; struct rgb888_t{uint8_t b,g,r;}; struct touch_point_t { int16_t x, y; uint16_t size, id; }; }
+class M5GFX { public:
+  void fillRect(int32_t,int32_t,int32_t,int32_t,uint32_t);
+  void drawRect(int32_t,int32_t,int32_t,int32_t,uint32_t);
+  void fillRoundRect(int32_t,int32_t,int32_t,int32_t,int32_t,uint32_t);
+  void drawRoundRect(int32_t,int32_t,int32_t,int32_t,int32_t,uint32_t);
+  void fillCircle(int32_t,int32_t,int32_t,uint32_t);
+  void drawCircle(int32_t,int32_t,int32_t,uint32_t);
+  void drawFastHLine(int32_t,int32_t,int32_t,uint32_t);
+  void drawFastVLine(int32_t,int32_t,int32_t,uint32_t);
+  void drawLine(int32_t,int32_t,int32_t,int32_t,uint32_t);
+  void drawPixel(int32_t,int32_t,uint32_t);
+  void setTextSize(float); void setTextColor(uint32_t); void setTextColor(uint32_t,uint32_t); void setTextDatum(uint8_t);
+  size_t drawString(const char*, int32_t, int32_t);
+  size_t drawChar(uint16_t, int32_t, int32_t);
+  void setEpdMode(epd_mode_t); epd_mode_t getEpdMode() const;
+  void display(); void display(int32_t,int32_t,int32_t,int32_t);
+  void waitDisplay(); bool displayBusy();
+  void fillScreen(uint32_t); void setAutoDisplay(bool);
+  void setClipRect(int32_t,int32_t,int32_t,int32_t); void clearClipRect();
+  void readRectRGB(int32_t,int32_t,int32_t,int32_t,uint8_t*);
+  void pushImage(int32_t,int32_t,int32_t,int32_t,const lgfx::rgb565_t*);
+  uint_fast8_t getTouch(lgfx::touch_point_t*, uint_fast8_t = 1);
+  void startWrite(); void endWrite();
+};
+struct TouchDetail { int16_t x, y; };
+struct Touch_Class { void begin(M5GFX*){} uint8_t getCount(); TouchDetail getDetail(uint8_t=0); bool isEnabled(); void update(uint32_t); };
+struct Button_Class { bool wasPressed(); };
+struct Power_Class { int16_t getBatteryVoltage(); };
+struct M5Unified { M5GFX Display; Touch_Class Touch; Button_Class BtnA, BtnB, BtnC; Power_Class Power; };
+extern M5Unified M5;
+// FreeRTOS surface
+typedef void* TaskHandle_t; typedef uint32_t TickType_t; typedef void (*TaskFunction_t)(void*);
+#define pdPASS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+int xTaskCreatePinnedToCore(TaskFunction_t, const char*, uint32_t, void*, unsigned, TaskHandle_t*, int);
+typedef void* SemaphoreHandle_t; inline SemaphoreHandle_t xSemaphoreCreateMutex(){static int m; return &m;} inline int xSemaphoreTake(SemaphoreHandle_t, TickType_t){return 1;} inline int xSemaphoreGive(SemaphoreHandle_t){return 1;}
+#define portMAX_DELAY 0xFFFFFFFF
+void vTaskDelay(TickType_t); void vTaskDelayUntil(TickType_t*, TickType_t); TickType_t xTaskGetTickCount(); void vTaskDelete(TaskHandle_t);
@@ -0,0 +1,4 @@
+#pragma once
+typedef enum { GPIO_NUM_0 = 0 } gpio_num_t;
+typedef enum { GPIO_INTR_LOW_LEVEL = 4 } gpio_int_type_t;
+int gpio_wakeup_enable(gpio_num_t, gpio_int_type_t); int gpio_wakeup_disable(gpio_num_t);
@@ -0,0 +1,6 @@
+#pragma once
+#include <stdlib.h>
+#define MALLOC_CAP_SPIRAM (1<<10)
+#define MALLOC_CAP_8BIT (1<<2)
+inline void* heap_caps_malloc(size_t n, unsigned){ return malloc(n); }
+inline void heap_caps_free(void* p){ free(p); }
@@ -0,0 +1,9 @@
+#pragma once
+#include <stdint.h>
+typedef enum { ESP_SLEEP_WAKEUP_ALL, ESP_SLEEP_WAKEUP_TIMER, ESP_SLEEP_WAKEUP_GPIO, ESP_SLEEP_WAKEUP_UNDEFINED } esp_sleep_source_t;
+typedef int esp_err_t;
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t);
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t);
+esp_err_t esp_sleep_enable_gpio_wakeup();
+esp_err_t esp_light_sleep_start();
+esp_sleep_source_t esp_sleep_get_wakeup_cause();
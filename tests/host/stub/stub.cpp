@@ -0,0 +1,83 @@
+// Host implementations of the stubbed M5Unified / Arduino / ESP-IDF calls
+#include <M5Unified.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include <stdarg.h>
+
+unsigned long millis() { return 0; }
+unsigned long micros() { return 0; }
+
+size_t Print::printf(const char* f, ...) {
+    va_list a;
+    va_start(a, f);
+    int n = vprintf(f, a);
+    va_end(a);
+    return n;
+}
+size_t Print::print(const char* s) { return ::printf("%s", s); }
+size_t Print::println(const char* s) { return ::printf("%s\n", s); }
+size_t Print::write(uint8_t c) { return ::putchar(c); }
+size_t Print::print(int v) { return ::printf("%d", v); }
+size_t Print::print(unsigned v) { return ::printf("%u", v); }
+size_t Print::print(long v) { return ::printf("%ld", v); }
+size_t Print::print(unsigned long v) { return ::printf("%lu", v); }
+
+HardwareSerial Serial;
+M5Unified M5;
+
+void M5GFX::fillRect(int32_t, int32_t, int32_t, int32_t, uint32_t) {}
+void M5GFX::drawRect(int32_t, int32_t, int32_t, int32_t, uint32_t) {}
+void M5GFX::fillRoundRect(int32_t, int32_t, int32_t, int32_t, int32_t, uint32_t) {}
+void M5GFX::drawRoundRect(int32_t, int32_t, int32_t, int32_t, int32_t, uint32_t) {}
+void M5GFX::fillCircle(int32_t, int32_t, int32_t, uint32_t) {}
+void M5GFX::drawCircle(int32_t, int32_t, int32_t, uint32_t) {}
+void M5GFX::drawFastHLine(int32_t, int32_t, int32_t, uint32_t) {}
+void M5GFX::drawFastVLine(int32_t, int32_t, int32_t, uint32_t) {}
+void M5GFX::drawLine(int32_t, int32_t, int32_t, int32_t, uint32_t) {}
+void M5GFX::drawPixel(int32_t, int32_t, uint32_t) {}
+void M5GFX::setTextSize(float) {}
+void M5GFX::setTextColor(uint32_t) {}
+void M5GFX::setTextColor(uint32_t, uint32_t) {}
+void M5GFX::setTextDatum(uint8_t) {}
+size_t M5GFX::drawString(const char*, int32_t, int32_t) { return 0; }
+size_t M5GFX::drawChar(uint16_t, int32_t, int32_t) { return 0; }
+static epd_mode_t s_mode = epd_quality;
+void M5GFX::setEpdMode(epd_mode_t m) { s_mode = m; }
+epd_mode_t M5GFX::getEpdMode() const { return s_mode; }
+void M5GFX::display() {}
+void M5GFX::display(int32_t, int32_t, int32_t, int32_t) {}
+void M5GFX::waitDisplay() {}
+bool M5GFX::displayBusy() { return false; }
+void M5GFX::fillScreen(uint32_t) {}
+void M5GFX::setAutoDisplay(bool) {}
+void M5GFX::setClipRect(int32_t, int32_t, int32_t, int32_t) {}
+void M5GFX::clearClipRect() {}
+void M5GFX::readRectRGB(int32_t, int32_t, int32_t w, int32_t h, uint8_t* d) { memset(d, 0xff, (size_t)w * h * 3); }
+void M5GFX::pushImage(int32_t, int32_t, int32_t, int32_t, const lgfx::rgb565_t*) {}
+uint_fast8_t M5GFX::getTouch(lgfx::touch_point_t*, uint_fast8_t) { return 0; }
+void M5GFX::startWrite() {}
+void M5GFX::endWrite() {}
+
+uint8_t Touch_Class::getCount() { return 0; }
+TouchDetail Touch_Class::getDetail(uint8_t) { return {0, 0}; }
+bool Touch_Class::isEnabled() { return true; }
+void Touch_Class::update(uint32_t) {}
+bool Button_Class::wasPressed() { return false; }
+int16_t Power_Class::getBatteryVoltage() { return 4000; }
+
+int xTaskCreatePinnedToCore(TaskFunction_t, const char*, uint32_t, void*, unsigned, TaskHandle_t* h, int) {
+    *h = (void*)1;
+    return pdPASS;
+}
+void vTaskDelay(TickType_t) {}
+void vTaskDelayUntil(TickType_t*, TickType_t) {}
+TickType_t xTaskGetTickCount() { return 0; }
+void vTaskDelete(TaskHandle_t) {}
+
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t) { return 0; }
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t) { return 0; }
+esp_err_t esp_sleep_enable_gpio_wakeup() { return 0; }
+esp_err_t esp_light_sleep_start() { return 0; }
+esp_sleep_source_t esp_sleep_get_wakeup_cause() { return ESP_SLEEP_WAKEUP_TIMER; }
+int gpio_wakeup_enable(gpio_num_t, gpio_int_type_t) { return 0; }
+int gpio_wakeup_disable(gpio_num_t) { return 0; }
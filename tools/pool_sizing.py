@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Generate a PaperUI pool sizing header from ui::dumpPoolStats() output.
+
+Capture the serial log of one or more sessions that visit every screen,
+then run:
+
+    python3 tools/pool_sizing.py serial.log > include/paperui_pools.h
+
+and include the result before <PaperUI.h>. When several dumps are present
+(multiple sessions, devices or screens) the highest watermark wins.
+"""
+
+import argparse
+import re
+import sys
+
+LINE_RE = re.compile(
+    r"\[PUI\] pool (?P<name>[A-Z_]+) count=\d+ peak=(?P<peak>\d+) "
+    r"cap=(?P<cap>\d+) item=(?P<item>\d+)"
+)
+
+
+def parse(stream):
+    pools = {}
+    for line in stream:
+        m = LINE_RE.search(line)
+        if not m:
+            continue
+        name = m.group("name")
+        peak = int(m.group("peak"))
+        item = int(m.group("item"))
+        prev = pools.get(name)
+        if prev is None or peak > prev[0]:
+            pools[name] = (peak, item)
+    return pools
+
+
+def render(pools, headroom):
+    out = [
+        "// Generated by tools/pool_sizing.py -- do not edit by hand.",
+        "// Include before <PaperUI.h>.",
+        "#pragma once",
+        "",
+    ]
+    total = 0
+    for name in sorted(pools):
+        peak, item = pools[name]
+        size = max(1, peak + headroom)  # StaticPool needs at least one slot
+        total += size * item
+        out.append("#define PAPERUI_POOL_%-9s %3d  // peak %d, %d B/slot"
+                   % (name, size, peak, item))
+    out.append("")
+    out.append("// Total pool memory: %d bytes" % total)
+    return "\n".join(out) + "\n"
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("logs", nargs="*", help="serial logs (default: stdin)")
+    ap.add_argument("--headroom", type=int, default=0,
+                    help="extra slots added to every pool")
+    args = ap.parse_args()
+
+    pools = {}
+    streams = [open(p) for p in args.logs] if args.logs else [sys.stdin]
+    for s in streams:
+        for name, (peak, item) in parse(s).items():
+            if name not in pools or peak > pools[name][0]:
+                pools[name] = (peak, item)
+
+    if not pools:
+        sys.exit("no '[PUI] pool' lines found")
+    sys.stdout.write(render(pools, args.headroom))
+
+
+if __name__ == "__main__":
+    main()
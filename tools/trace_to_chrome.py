@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""Convert PaperUI::Trace::dump() output to Chrome trace JSON.
+
+Build with -DPAPERUI_TRACE, call PaperUI::Trace::dump(Serial) when the
+interesting part is over, capture the serial log, then run:
+
+    python3 tools/trace_to_chrome.py serial.log > trace.json
+
+and open trace.json in chrome://tracing or https://ui.perfetto.dev.
+Draw slices are named after the widget id (or node index when the id is
+0); push slices carry the rect and EPD mode. Several dumps in one log are
+laid out one after another.
+"""
+
+import argparse
+import json
+import re
+import sys
+
+LINE_RE = re.compile(
+    r"^T (?P<us>\d+) (?P<ph>[BE]) (?P<name>\w+) (?P<node>\d+) (?P<wid>\d+) "
+    r"(?P<x>-?\d+) (?P<y>-?\d+) (?P<w>-?\d+) (?P<h>-?\d+) (?P<mode>\d+)"
+)
+
+EPD_MODES = {0: "quality", 1: "text", 2: "fast", 3: "fastest"}
+NO_NODE = 0xFFFF
+
+# Threads in the viewer, so nested draws don't hide pushes
+TID = {"push": 2, "touch": 3}
+
+
+def slice_name(m):
+    name = m.group("name")
+    if name == "draw":
+        wid = int(m.group("wid"))
+        return "draw id=%d" % wid if wid else "draw node=%s" % m.group("node")
+    if name == "push":
+        return "push %s" % EPD_MODES.get(int(m.group("mode")), m.group("mode"))
+    return name
+
+
+def args_for(m):
+    a = {}
+    node = int(m.group("node"))
+    if node != NO_NODE:
+        a["node"] = node
+        a["id"] = int(m.group("wid"))
+    w, h = int(m.group("w")), int(m.group("h"))
+    if w or h:
+        a["rect"] = "%s,%s %dx%d" % (m.group("x"), m.group("y"), w, h)
+        a["pixels"] = w * h
+    if m.group("name") == "push":
+        a["mode"] = EPD_MODES.get(int(m.group("mode")), m.group("mode"))
+    return a
+
+
+def convert(stream):
+    events = []
+    open_slices = {}   # (tid, name) -> depth, to drop ENDs whose BEGIN was overwritten
+    offset = 0         # shifts a dump whose clock restarted (reboot) past the last one
+    last_ts = 0
+    new_dump = False
+    for line in stream:
+        if "[PUI] trace" in line and "events" in line:
+            new_dump = True
+            open_slices.clear()
+            continue
+        m = LINE_RE.search(line.strip())
+        if not m:
+            continue
+        raw = int(m.group("us"))
+        if new_dump:
+            new_dump = False
+            if raw + offset < last_ts:
+                offset = last_ts - raw
+        ts = raw + offset
+        last_ts = max(last_ts, ts)
+        tid = TID.get(m.group("name"), 1)
+        name = slice_name(m)
+        key = (tid, name)
+        if m.group("ph") == "B":
+            open_slices[key] = open_slices.get(key, 0) + 1
+        elif open_slices.get(key, 0) > 0:
+            open_slices[key] -= 1
+        else:
+            continue
+        ev = {"name": name, "cat": m.group("name"), "ph": m.group("ph"),
+              "ts": ts, "pid": 1, "tid": tid}
+        if m.group("ph") == "B":
+            ev["args"] = args_for(m)
+        events.append(ev)
+    meta = [{"name": "thread_name", "ph": "M", "pid": 1, "tid": t,
+             "args": {"name": n}}
+            for n, t in (("render", 1), ("display", 2), ("touch", 3))]
+    return {"traceEvents": meta + events, "displayTimeUnit": "ms"}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("logs", nargs="*", help="serial logs (default: stdin)")
+    args = ap.parse_args()
+
+    streams = [open(p) for p in args.logs] if args.logs else [sys.stdin]
+    trace = {"traceEvents": [], "displayTimeUnit": "ms"}
+    for s in streams:
+        part = convert(s)
+        trace["traceEvents"].extend(
+            e for e in part["traceEvents"]
+            if e["ph"] != "M" or e not in trace["traceEvents"])
+
+    if not any(e["ph"] != "M" for e in trace["traceEvents"]):
+        sys.exit("no 'T ' trace lines found")
+    json.dump(trace, sys.stdout, indent=1)
+    sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()